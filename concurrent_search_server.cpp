@@ -0,0 +1,126 @@
+#include "concurrent_search_server.h"
+
+#include <thread>
+
+ConcurrentSearchServer::ConcurrentSearchServer(SearchServer&& first, SearchServer&& second)
+    : servers_{ std::move(first), std::move(second) }
+{
+}
+
+void ConcurrentSearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings) {
+    Write([document_id, document, status, &ratings](SearchServer& server) {
+        server.AddDocument(document_id, document, status, ratings);
+    });
+}
+
+void ConcurrentSearchServer::AddDocuments(const std::vector<NewDocument>& documents) {
+    AddDocuments(std::execution::seq, documents);
+}
+
+void ConcurrentSearchServer::RemoveDocument(int document_id) {
+    RemoveDocument(std::execution::seq, document_id);
+}
+
+void ConcurrentSearchServer::RemoveDocuments(const std::vector<int>& document_ids) {
+    RemoveDocuments(std::execution::seq, document_ids);
+}
+
+void ConcurrentSearchServer::SetIdfConsistency(IdfConsistency consistency) {
+    Write([consistency](SearchServer& server) {
+        server.SetIdfConsistency(consistency);
+    });
+}
+
+void ConcurrentSearchServer::SetPostingFormat(PostingFormat format) {
+    Write([format](SearchServer& server) {
+        server.SetPostingFormat(format);
+    });
+}
+
+void ConcurrentSearchServer::SetPositionIndexing(bool enabled) {
+    Write([enabled](SearchServer& server) {
+        server.SetPositionIndexing(enabled);
+    });
+}
+
+void ConcurrentSearchServer::SetProximityWeight(double weight) {
+    Write([weight](SearchServer& server) {
+        server.SetProximityWeight(weight);
+    });
+}
+
+void ConcurrentSearchServer::SetMaxPrefixExpansion(size_t max_term_count) {
+    Write([max_term_count](SearchServer& server) {
+        server.SetMaxPrefixExpansion(max_term_count);
+    });
+}
+
+void ConcurrentSearchServer::SetMaxEditDistance(size_t max_distance) {
+    Write([max_distance](SearchServer& server) {
+        server.SetMaxEditDistance(max_distance);
+    });
+}
+
+void ConcurrentSearchServer::SetMaxResultDocumentCount(size_t result_count) {
+    Write([result_count](SearchServer& server) {
+        server.SetMaxResultDocumentCount(result_count);
+    });
+}
+
+void ConcurrentSearchServer::SetResultCacheCapacity(size_t capacity_bytes) {
+    Write([capacity_bytes](SearchServer& server) {
+        server.SetResultCacheCapacity(capacity_bytes);
+    });
+}
+
+std::map<std::string_view, double> ConcurrentSearchServer::GetWordFrequencies(int document_id) const {
+    return Read([document_id](const SearchServer& server) {
+        return server.GetWordFrequencies(document_id);
+    });
+}
+
+int ConcurrentSearchServer::GetDocumentCount() const {
+    return Read([](const SearchServer& server) {
+        return server.GetDocumentCount();
+    });
+}
+
+std::vector<int> ConcurrentSearchServer::GetDocumentIds() const {
+    return Read([](const SearchServer& server) {
+        return std::vector<int>(server.begin(), server.end());
+    });
+}
+
+void ConcurrentSearchServer::SaveSnapshot(const std::string& path) const {
+    Read([&path](const SearchServer& server) {
+        server.SaveSnapshot(path);
+    });
+}
+
+ConcurrentSearchServer ConcurrentSearchServer::LoadSnapshot(const std::string& path) {
+    // обе копии отображают один файл, так что постинги и термы в памяти не дублируются
+    return ConcurrentSearchServer(SearchServer::LoadSnapshot(path), SearchServer::LoadSnapshot(path));
+}
+
+size_t ConcurrentSearchServer::EnterRead() const noexcept {
+    // если писатель переключил копию между чтением active_ и регистрацией, уходим и пробуем снова:
+    // писатель ждёт только тех, кто зарегистрировался на копии до переключения
+    while (true) {
+        const size_t side = active_.load();
+        readers_[side].value.fetch_add(1);
+        if (active_.load() == side) {
+            return side;
+        }
+        readers_[side].value.fetch_sub(1);
+    }
+}
+
+void ConcurrentSearchServer::LeaveRead(size_t side) const noexcept {
+    readers_[side].value.fetch_sub(1);
+}
+
+void ConcurrentSearchServer::WaitForReaders(size_t side) const noexcept {
+    while (readers_[side].value.load() != 0) {
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "search_server.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Поисковый сервер, который читают из многих потоков, пока другой поток его изменяет (схема left-right).
+// Индекс хранится в двух копиях: читатели работают с активной, писатель меняет неактивную,
+// переключает на неё читателей, дожидается ухода читателей со старой копии и повторяет изменение там.
+// Читатели не ждут писателя и не блокируют друг друга; писатели выполняются по очереди.
+// Плата - двойная память под индекс и двойная работа писателя.
+class ConcurrentSearchServer {
+public:
+    template <typename StopWords>
+    explicit ConcurrentSearchServer(const StopWords& stop_words)
+        : servers_{ SearchServer(stop_words), SearchServer(stop_words) }
+    {
+    }
+
+    // Выполняет function(const SearchServer&) над актуальной копией индекса. Всё, что function
+    // получила от сервера по ссылке, можно использовать только внутри вызова.
+    template <typename Function>
+    auto Read(Function function) const;
+
+    // Применяет function(SearchServer&) к обеим копиям индекса, поэтому она должна быть детерминированной.
+    // Если function бросает исключение на первой копии, изменение не публикуется: методы SearchServer
+    // проверяют входные данные до изменения индекса.
+    template <typename Function>
+    void Write(Function function);
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+
+    template <typename ExecutionPolicy>
+    void AddDocuments(ExecutionPolicy policy, const std::vector<NewDocument>& documents);
+    void AddDocuments(const std::vector<NewDocument>& documents);
+
+    template <typename ExecutionPolicy>
+    void RemoveDocument(ExecutionPolicy policy, int document_id);
+    void RemoveDocument(int document_id);
+
+    template <typename ExecutionPolicy>
+    void RemoveDocuments(ExecutionPolicy policy, const std::vector<int>& document_ids);
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+    void SetIdfConsistency(IdfConsistency consistency);
+    void SetPostingFormat(PostingFormat format);
+    void SetPositionIndexing(bool enabled);
+    void SetProximityWeight(double weight);
+    void SetMaxPrefixExpansion(size_t max_term_count);
+    void SetMaxEditDistance(size_t max_distance);
+    void SetMaxResultDocumentCount(size_t result_count);
+    // у каждой копии индекса свой кэш
+    void SetResultCacheCapacity(size_t capacity_bytes);
+
+    template <typename... Args>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(const Args&... args) const;
+
+    template <typename... Args>
+    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const Args&... args) const;
+
+    // Карта возвращается копией: карта в индексе может быть удалена вместе с документом,
+    // а string_view на слова действительны всё время жизни сервера - словарь только растёт.
+    [[nodiscard]] std::map<std::string_view, double> GetWordFrequencies(int document_id) const;
+
+    [[nodiscard]] int GetDocumentCount() const;
+    [[nodiscard]] std::vector<int> GetDocumentIds() const;
+
+    void SaveSnapshot(const std::string& path) const;
+    [[nodiscard]] static ConcurrentSearchServer LoadSnapshot(const std::string& path);
+
+private:
+    // счётчики читателей на разных кэш-линиях, чтобы читатели двух копий не мешали друг другу
+    struct alignas(64) ReaderCount {
+        std::atomic<size_t> value{ 0 };
+    };
+
+    ConcurrentSearchServer(SearchServer&& first, SearchServer&& second);
+
+    [[nodiscard]] size_t EnterRead() const noexcept;
+    void LeaveRead(size_t side) const noexcept;
+    void WaitForReaders(size_t side) const noexcept;
+
+    std::array<SearchServer, 2> servers_;
+    std::atomic<size_t> active_{ 0 };
+    mutable std::array<ReaderCount, 2> readers_;
+    std::mutex write_mutex_;
+};
+
+template <typename Function>
+auto ConcurrentSearchServer::Read(Function function) const {
+    struct ReadGuard {
+        const ConcurrentSearchServer& server;
+        const size_t side;
+        ~ReadGuard() {
+            server.LeaveRead(side);
+        }
+    };
+    const ReadGuard guard{ *this, EnterRead() };
+    return function(servers_[guard.side]);
+}
+
+template <typename Function>
+void ConcurrentSearchServer::Write(Function function) {
+    std::lock_guard guard(write_mutex_);
+    const size_t active = active_.load();
+    function(servers_[1 - active]);
+    active_.store(1 - active);
+    WaitForReaders(active);
+    function(servers_[active]);
+}
+
+template <typename ExecutionPolicy>
+void ConcurrentSearchServer::AddDocuments(ExecutionPolicy policy, const std::vector<NewDocument>& documents) {
+    Write([policy, &documents](SearchServer& server) {
+        server.AddDocuments(policy, documents);
+    });
+}
+
+template <typename ExecutionPolicy>
+void ConcurrentSearchServer::RemoveDocument(ExecutionPolicy policy, int document_id) {
+    Write([policy, document_id](SearchServer& server) {
+        server.RemoveDocument(policy, document_id);
+    });
+}
+
+template <typename ExecutionPolicy>
+void ConcurrentSearchServer::RemoveDocuments(ExecutionPolicy policy, const std::vector<int>& document_ids) {
+    Write([policy, &document_ids](SearchServer& server) {
+        server.RemoveDocuments(policy, document_ids);
+    });
+}
+
+template <typename... Args>
+std::vector<Document> ConcurrentSearchServer::FindTopDocuments(const Args&... args) const {
+    return Read([&args...](const SearchServer& server) {
+        return server.FindTopDocuments(args...);
+    });
+}
+
+template <typename... Args>
+std::tuple<std::vector<std::string_view>, DocumentStatus> ConcurrentSearchServer::MatchDocument(const Args&... args) const {
+    return Read([&args...](const SearchServer& server) {
+        return server.MatchDocument(args...);
+    });
+}
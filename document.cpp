@@ -1,14 +1,22 @@
-#include "document.h"
-
-#include <string>
-
-using namespace std::string_literals;
-
-std::ostream& operator<<(std::ostream& out, const Document& document) {
-    out << "{ "s
-        << "document_id = "s << document.id << ", "s
-        << "relevance = "s << document.relevance << ", "s
-    << "rating = "s << document.rating << " }"s;
-    return out;
-}
-
+#include "document.h"
+
+#include <string>
+
+using namespace std::string_literals;
+
+std::ostream& operator<<(std::ostream& out, const Document& document) {
+    out << "{ "s
+        << "document_id = "s << document.id << ", "s
+        << "relevance = "s << document.relevance << ", "s
+    << "rating = "s << document.rating << " }"s;
+    return out;
+}
+
+
+IteratorRange<std::vector<Document>::const_iterator> DocumentBatch::operator[](size_t index) const {
+    return { documents.begin() + offsets.at(index), documents.begin() + offsets.at(index + 1) };
+}
+
+size_t DocumentBatch::size() const noexcept {
+    return offsets.size() - 1;
+}
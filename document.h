@@ -1,25 +1,54 @@
-#pragma once
-#include <iostream>
-
-enum class DocumentStatus {
-    ACTUAL,
-    IRRELEVANT,
-    BANNED,
-    REMOVED,
-};
-
-struct Document {
-    Document() = default;
-
-    Document(int id, double relevance, int rating)
-        : id(id)
-        , relevance(relevance)
-        , rating(rating) {
-    }
-
-    int id = 0;
-    double relevance = 0.0;
-    int rating = 0;
-};
-
-std::ostream& operator<<(std::ostream& out, const Document& document);
+#pragma once
+#include "paginator.h"
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+enum class DocumentStatus {
+    ACTUAL,
+    IRRELEVANT,
+    BANNED,
+    REMOVED,
+};
+
+struct Document {
+    Document() = default;
+
+    Document(int id, double relevance, int rating)
+        : id(id)
+        , relevance(relevance)
+        , rating(rating) {
+    }
+
+    int id = 0;
+    double relevance = 0.0;
+    int rating = 0;
+};
+
+// документ для пакетного добавления SearchServer::AddDocuments
+struct NewDocument {
+    int id = 0;
+    std::string_view text;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+};
+
+// Результаты пакета запросов в одном буфере: документы запроса i лежат в
+// documents[offsets[i], offsets[i + 1])
+struct DocumentBatch {
+    std::vector<Document> documents;
+    std::vector<size_t> offsets{ 0 };
+
+    template <typename Iterator>
+    void Append(Iterator first, Iterator last) {
+        documents.insert(documents.end(), first, last);
+        offsets.push_back(documents.size());
+    }
+
+    [[nodiscard]] IteratorRange<std::vector<Document>::const_iterator> operator[](size_t index) const;
+
+    [[nodiscard]] size_t size() const noexcept;
+};
+
+std::ostream& operator<<(std::ostream& out, const Document& document);
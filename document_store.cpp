@@ -0,0 +1,178 @@
+#include "document_store.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    int CountTrailingZeros(uint64_t value) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+}
+
+int DocumentStore::Add(int document_id, DocumentStatus status, int rating, uint32_t length) {
+    if (number_to_document_id_.size() >= static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::length_error(std::string{ "document numbers are exhausted" });
+    }
+    const int document_number = static_cast<int>(number_to_document_id_.size());
+    if (!numbers_.emplace(document_id, document_number).second) {
+        throw std::invalid_argument(std::string{ "документ с таким id уже существует!" });
+    }
+    document_ids_.insert(document_id);
+    number_to_document_id_.push_back(document_id);
+    ratings_.push_back(rating);
+    lengths_.push_back(length);
+    total_length_ += length;
+    const size_t word_count = number_to_document_id_.size() / 64 + 1;
+    for (std::vector<uint64_t>& bits : status_bits_) {
+        bits.resize(word_count, 0);
+    }
+    alive_bits_.resize(word_count, 0);
+    status_bits_[static_cast<size_t>(status)][document_number / 64] |= uint64_t{ 1 } << (document_number % 64);
+    alive_bits_[document_number / 64] |= uint64_t{ 1 } << (document_number % 64);
+    return document_number;
+}
+
+void DocumentStore::Remove(int document_number) {
+    const int document_id = GetDocumentId(document_number);
+    if (numbers_.erase(document_id) == 0) {
+        return;
+    }
+    document_ids_.erase(document_id);
+    total_length_ -= lengths_[document_number];
+    for (std::vector<uint64_t>& bits : status_bits_) {
+        bits[document_number / 64] &= ~(uint64_t{ 1 } << (document_number % 64));
+    }
+    alive_bits_[document_number / 64] &= ~(uint64_t{ 1 } << (document_number % 64));
+}
+
+std::vector<int> DocumentStore::Compact() {
+    std::vector<int> new_numbers(number_to_document_id_.size(), -1);
+    std::vector<int> number_to_document_id;
+    std::vector<int> ratings;
+    std::vector<uint32_t> lengths;
+    number_to_document_id.reserve(numbers_.size());
+    ratings.reserve(numbers_.size());
+    lengths.reserve(numbers_.size());
+    const size_t word_count = numbers_.size() / 64 + 1;
+    std::array<std::vector<uint64_t>, STATUS_COUNT> status_bits;
+    for (std::vector<uint64_t>& bits : status_bits) {
+        bits.assign(word_count, 0);
+    }
+    std::vector<uint64_t> alive_bits(word_count, 0);
+    for (int document_number = 0; document_number < GetNumberCount(); ++document_number) {
+        if (!IsAlive(document_number)) {
+            continue;
+        }
+        const int new_number = static_cast<int>(number_to_document_id.size());
+        const uint64_t bit = uint64_t{ 1 } << (new_number % 64);
+        for (size_t status = 0; status < STATUS_COUNT; ++status) {
+            if (TestBit(status_bits_[status], document_number)) {
+                status_bits[status][new_number / 64] |= bit;
+            }
+        }
+        alive_bits[new_number / 64] |= bit;
+        new_numbers[document_number] = new_number;
+        numbers_[number_to_document_id_[document_number]] = new_number;
+        number_to_document_id.push_back(number_to_document_id_[document_number]);
+        ratings.push_back(ratings_[document_number]);
+        lengths.push_back(lengths_[document_number]);
+    }
+    number_to_document_id_ = std::move(number_to_document_id);
+    ratings_ = std::move(ratings);
+    lengths_ = std::move(lengths);
+    status_bits_ = std::move(status_bits);
+    alive_bits_ = std::move(alive_bits);
+    return new_numbers;
+}
+
+int DocumentStore::FindNumber(int document_id) const noexcept {
+    const auto iter = numbers_.find(document_id);
+    return iter == numbers_.end() ? -1 : iter->second;
+}
+
+bool DocumentStore::Contains(int document_id) const noexcept {
+    return numbers_.count(document_id) > 0;
+}
+
+int DocumentStore::GetDocumentId(int document_number) const {
+    return number_to_document_id_.at(document_number);
+}
+
+DocumentStatus DocumentStore::GetStatus(int document_number) const {
+    for (size_t status = 0; status < STATUS_COUNT; ++status) {
+        if (HasStatus(document_number, static_cast<DocumentStatus>(status))) {
+            return static_cast<DocumentStatus>(status);
+        }
+    }
+    throw std::out_of_range(std::string{ "document not found" });
+}
+
+int DocumentStore::GetRating(int document_number) const {
+    return ratings_.at(document_number);
+}
+
+uint64_t DocumentStore::GetTotalLength() const noexcept {
+    return total_length_;
+}
+
+double DocumentStore::GetAverageLength() const noexcept {
+    return numbers_.empty() ? 0.0 : static_cast<double>(total_length_) / static_cast<double>(numbers_.size());
+}
+
+int DocumentStore::FindNext(DocumentStatus status, int document_number) const noexcept {
+    return FindNextBit(status_bits_[static_cast<size_t>(status)], document_number);
+}
+
+int DocumentStore::FindNextAlive(int document_number) const noexcept {
+    return FindNextBit(alive_bits_, document_number);
+}
+
+const std::vector<uint64_t>& DocumentStore::GetAliveBits() const noexcept {
+    return alive_bits_;
+}
+
+int DocumentStore::FindNextBit(const std::vector<uint64_t>& bits, int document_number) noexcept {
+    const size_t first = static_cast<size_t>(std::max(document_number, 0));
+    size_t word_index = first / 64;
+    if (word_index >= bits.size()) {
+        return -1;
+    }
+    // биты левее first в первом слове отбрасываются
+    uint64_t word = bits[word_index] & (~uint64_t{ 0 } << (first % 64));
+    while (word == 0) {
+        if (++word_index == bits.size()) {
+            return -1;
+        }
+        word = bits[word_index];
+    }
+    return static_cast<int>(word_index * 64) + CountTrailingZeros(word);
+}
+
+size_t DocumentStore::size() const noexcept {
+    return numbers_.size();
+}
+
+int DocumentStore::GetNumberCount() const noexcept {
+    return static_cast<int>(number_to_document_id_.size());
+}
+
+std::set<int>::const_iterator DocumentStore::begin() const noexcept {
+    return document_ids_.begin();
+}
+
+std::set<int>::const_iterator DocumentStore::end() const noexcept {
+    return document_ids_.end();
+}
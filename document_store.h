@@ -0,0 +1,91 @@
+#pragma once
+
+#include "document.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Документы в плотной внутренней нумерации: номер выдаётся по порядку добавления,
+// а внешний id, рейтинг, статус и длина хранятся столбцами, индексируемыми номером.
+// Для каждого статуса хранится битовая маска номеров, поэтому отбор по статусу сводится
+// к проверке бита, а поиск следующего подходящего документа - к сканированию слов маски.
+// Удаление только снимает бит документа в масках (надгробие), постинги удалённых документов
+// отбрасываются позже при слиянии сегментов; поэтому номер удалённого документа сразу не переиспользуется,
+// а освобождается сжатием нумерации (Compact), после которого номера выдаются заново.
+class DocumentStore {
+public:
+    // номер нового документа; id не должен быть уже добавлен. length - число нестоп-слов
+    int Add(int document_id, DocumentStatus status, int rating, uint32_t length);
+    void Remove(int document_number);
+    // Перенумеровывает неудалённые документы подряд с сохранением порядка и освобождает столбцы удалённых.
+    // Возвращает новый номер для каждого прежнего, -1 для удалённых
+    std::vector<int> Compact();
+
+    // номер документа или -1
+    [[nodiscard]] int FindNumber(int document_id) const noexcept;
+    [[nodiscard]] bool Contains(int document_id) const noexcept;
+
+    [[nodiscard]] int GetDocumentId(int document_number) const;
+    [[nodiscard]] bool IsAlive(int document_number) const noexcept;
+    [[nodiscard]] bool HasStatus(int document_number, DocumentStatus status) const noexcept;
+    [[nodiscard]] DocumentStatus GetStatus(int document_number) const;
+    [[nodiscard]] int GetRating(int document_number) const;
+    // без проверки номера: читается на каждый постинг при ранжировании с учётом длины
+    [[nodiscard]] uint32_t GetLength(int document_number) const noexcept;
+    // суммарная и средняя длина неудалённых документов
+    [[nodiscard]] uint64_t GetTotalLength() const noexcept;
+    [[nodiscard]] double GetAverageLength() const noexcept;
+
+    // наименьший номер >= document_number со статусом status или -1
+    [[nodiscard]] int FindNext(DocumentStatus status, int document_number) const noexcept;
+    // наименьший номер >= document_number неудалённого документа или -1
+    [[nodiscard]] int FindNextAlive(int document_number) const noexcept;
+
+    // маска неудалённых документов: бит номера n - в слове n / 64
+    [[nodiscard]] const std::vector<uint64_t>& GetAliveBits() const noexcept;
+
+    // число документов и число выданных номеров (включая удалённые)
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] int GetNumberCount() const noexcept;
+
+    // внешние id по возрастанию
+    [[nodiscard]] std::set<int>::const_iterator begin() const noexcept;
+    [[nodiscard]] std::set<int>::const_iterator end() const noexcept;
+
+private:
+    static constexpr size_t STATUS_COUNT = static_cast<size_t>(DocumentStatus::REMOVED) + 1;
+
+    [[nodiscard]] static bool TestBit(const std::vector<uint64_t>& bits, int document_number) noexcept;
+    [[nodiscard]] static int FindNextBit(const std::vector<uint64_t>& bits, int document_number) noexcept;
+
+    std::unordered_map<int, int> numbers_;
+    std::set<int> document_ids_;
+    std::vector<int> number_to_document_id_;
+    std::vector<int> ratings_;
+    std::vector<uint32_t> lengths_;
+    // суммарная длина неудалённых документов
+    uint64_t total_length_ = 0;
+    std::array<std::vector<uint64_t>, STATUS_COUNT> status_bits_;
+    std::vector<uint64_t> alive_bits_;
+};
+
+inline bool DocumentStore::TestBit(const std::vector<uint64_t>& bits, int document_number) noexcept {
+    const size_t index = static_cast<size_t>(document_number);
+    return document_number >= 0 && index / 64 < bits.size() && ((bits[index / 64] >> (index % 64)) & 1);
+}
+
+inline bool DocumentStore::IsAlive(int document_number) const noexcept {
+    return TestBit(alive_bits_, document_number);
+}
+
+inline uint32_t DocumentStore::GetLength(int document_number) const noexcept {
+    return lengths_[document_number];
+}
+
+inline bool DocumentStore::HasStatus(int document_number, DocumentStatus status) const noexcept {
+    return TestBit(status_bits_[static_cast<size_t>(status)], document_number);
+}
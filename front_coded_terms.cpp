@@ -0,0 +1,171 @@
+#include "front_coded_terms.h"
+
+#include <algorithm>
+
+namespace {
+    uint64_t ReadVarint(const uint8_t*& data) noexcept {
+        uint64_t value = 0;
+        for (int shift = 0; ; shift += 7) {
+            const uint8_t byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+}
+
+// Дописывает термы по возрастанию в конец списка. Запись идёт в заранее выделенный буфер
+// через указатель: на каждый терм приходится пара байт длин и копия остатка
+class FrontCodedTerms::Encoder {
+public:
+    Encoder(FrontCodedTerms& terms, size_t expected_size, size_t expected_bytes)
+        : terms_(terms) {
+        terms_.data_.resize(expected_bytes);
+        terms_.block_offsets_.reserve(expected_size / BLOCK_SIZE + 1);
+        terms_.ids_.reserve(expected_size);
+    }
+
+    void Append(std::string_view term, uint32_t id) {
+        size_t shared = 0;
+        if (terms_.ids_.size() % BLOCK_SIZE == 0) {
+            terms_.block_offsets_.push_back(size_);
+        }
+        else {
+            const size_t max_shared = std::min(previous_.size(), term.size());
+            while (shared < max_shared && previous_[shared] == term[shared]) {
+                ++shared;
+            }
+        }
+        const size_t suffix_size = term.size() - shared;
+        if (size_ + 2 * MAX_VARINT_SIZE + suffix_size > terms_.data_.size()) {
+            terms_.data_.resize(std::max(terms_.data_.size() * 2, size_ + 2 * MAX_VARINT_SIZE + suffix_size));
+        }
+        uint8_t* out = terms_.data_.data() + size_;
+        out = WriteVarint(shared, out);
+        out = WriteVarint(suffix_size, out);
+        std::copy_n(term.data() + shared, suffix_size, out);
+        size_ = out + suffix_size - terms_.data_.data();
+        terms_.ids_.push_back(id);
+        previous_.replace(shared, std::string::npos, term.data() + shared, suffix_size);
+    }
+
+    void Finish() {
+        terms_.data_.resize(size_);
+        terms_.data_.shrink_to_fit();
+    }
+
+private:
+    static constexpr size_t MAX_VARINT_SIZE = 10;
+
+    static uint8_t* WriteVarint(uint64_t value, uint8_t* out) noexcept {
+        while (value >= 0x80) {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    FrontCodedTerms& terms_;
+    size_t size_ = 0;
+    std::string previous_;
+};
+
+void FrontCodedTerms::Build(const std::vector<std::pair<std::string_view, uint32_t>>& sorted_terms) {
+    size_t expected_bytes = 0;
+    for (const auto& [term, id] : sorted_terms) {
+        expected_bytes += term.size() + 2;
+    }
+    *this = FrontCodedTerms{};
+    Encoder encoder(*this, sorted_terms.size(), expected_bytes);
+    for (const auto& [term, id] : sorted_terms) {
+        encoder.Append(term, id);
+    }
+    encoder.Finish();
+}
+
+FrontCodedTerms FrontCodedTerms::Merge(const std::vector<FrontCodedTerms>& runs) {
+    struct Cursor {
+        const FrontCodedTerms* run;
+        const uint8_t* data;
+        size_t index;
+        std::string term;
+    };
+    std::vector<Cursor> cursors;
+    size_t expected_size = 0;
+    size_t expected_bytes = 0;
+    for (const FrontCodedTerms& run : runs) {
+        expected_size += run.size();
+        expected_bytes += run.data_.size();
+        if (run.size() > 0) {
+            cursors.push_back({ &run, run.data_.data(), 0, {} });
+            cursors.back().data = DecodeTerm(cursors.back().data, cursors.back().term);
+        }
+    }
+
+    FrontCodedTerms result;
+    Encoder encoder(result, expected_size, expected_bytes);
+    // прогонов немного, поэтому наименьший терм ищется простым проходом
+    while (!cursors.empty()) {
+        size_t min = 0;
+        for (size_t i = 1; i < cursors.size(); ++i) {
+            if (cursors[i].term < cursors[min].term) {
+                min = i;
+            }
+        }
+        Cursor& cursor = cursors[min];
+        encoder.Append(cursor.term, cursor.run->ids_[cursor.index]);
+        if (++cursor.index < cursor.run->size()) {
+            cursor.data = DecodeTerm(cursor.data, cursor.term);
+        }
+        else {
+            cursors.erase(cursors.begin() + min);
+        }
+    }
+    encoder.Finish();
+    return result;
+}
+
+size_t FrontCodedTerms::size() const noexcept {
+    return ids_.size();
+}
+
+std::string_view FrontCodedTerms::GetBlockFirstTerm(size_t block) const noexcept {
+    const uint8_t* data = data_.data() + block_offsets_[block];
+    ReadVarint(data);
+    const size_t size = static_cast<size_t>(ReadVarint(data));
+    return { reinterpret_cast<const char*>(data), size };
+}
+
+size_t FrontCodedTerms::FindBlockAfter(std::string_view term, size_t block) const noexcept {
+    // переходы обычно короткие, поэтому граница ищется удвоением шага от текущего блока,
+    // а двоичный поиск идёт только внутри последнего шага
+    size_t first = block + 1;
+    size_t step = 1;
+    while (first < block_offsets_.size() && GetBlockFirstTerm(first) <= term) {
+        block = first;
+        first += step;
+        step *= 2;
+    }
+    size_t last = std::min(first, block_offsets_.size());
+    first = block + 1;
+    while (first < last) {
+        const size_t middle = first + (last - first) / 2;
+        if (GetBlockFirstTerm(middle) <= term) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+const uint8_t* FrontCodedTerms::DecodeTerm(const uint8_t* data, std::string& term) {
+    const size_t shared = static_cast<size_t>(ReadVarint(data));
+    const size_t suffix_size = static_cast<size_t>(ReadVarint(data));
+    term.resize(shared);
+    term.append(reinterpret_cast<const char*>(data), suffix_size);
+    return data + suffix_size;
+}
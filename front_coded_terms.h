@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Термы по возрастанию, сжатые префиксным кодированием блоками по BLOCK_SIZE: каждый терм хранится
+// длиной общего с предыдущим префикса и остатком, первый терм блока - целиком. Термы с общим
+// префиксом лежат подряд, поэтому поиск по префиксу - двоичный поиск по первым термам блоков
+// и чтение блоков вперёд, пока термы начинаются с префикса.
+class FrontCodedTerms {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;
+
+    // sorted_terms - пары (терм, id) по возрастанию термов
+    void Build(const std::vector<std::pair<std::string_view, uint32_t>>& sorted_terms);
+
+    // Слияние списков без общих термов. Каждый читается последовательно,
+    // поэтому слияние стоит O(суммы размеров) без обращений к строкам словаря
+    [[nodiscard]] static FrontCodedTerms Merge(const std::vector<FrontCodedTerms>& runs);
+
+    [[nodiscard]] size_t size() const noexcept;
+
+    // function(std::string_view term, uint32_t id) для каждого терма с префиксом prefix по возрастанию;
+    // term действителен только во время вызова
+    template <typename Function>
+    void ForEachWithPrefix(std::string_view prefix, Function function) const;
+
+    // Пересечение с автоматом (см. LevenshteinAutomaton): size_t automaton.Feed(term) возвращает длину
+    // префикса term, после которого автомат мёртв, или 0, а bool automaton.FindNextAlivePrefix(target)
+    // называет следующий живой префикс. Термы до него пропускаются: внутри блока - без подачи
+    // автомату, дальше - поиском по первым термам блоков.
+    // function(std::string_view term, uint32_t id) для каждого принятого терма по возрастанию
+    template <typename Automaton, typename Function>
+    void ForEachAccepted(Automaton& automaton, Function function) const;
+
+private:
+    class Encoder;
+
+    [[nodiscard]] std::string_view GetBlockFirstTerm(size_t block) const noexcept;
+    // первый блок после block, который начинается с терма больше term
+    [[nodiscard]] size_t FindBlockAfter(std::string_view term, size_t block) const noexcept;
+    // дописывает к общему префиксу в term остаток следующего терма; возвращает конец его записи
+    static const uint8_t* DecodeTerm(const uint8_t* data, std::string& term);
+
+    std::vector<uint8_t> data_;
+    std::vector<uint64_t> block_offsets_;
+    std::vector<uint32_t> ids_;
+};
+
+template <typename Function>
+void FrontCodedTerms::ForEachWithPrefix(std::string_view prefix, Function function) const {
+    // первый блок, который начинается не раньше prefix; совпадения могут начаться в предыдущем
+    size_t first = 0;
+    size_t last = block_offsets_.size();
+    while (first < last) {
+        const size_t middle = first + (last - first) / 2;
+        if (GetBlockFirstTerm(middle) < prefix) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+
+    std::string term;
+    for (size_t block = first == 0 ? 0 : first - 1; block < block_offsets_.size(); ++block) {
+        const uint8_t* data = data_.data() + block_offsets_[block];
+        const size_t end = std::min(ids_.size(), (block + 1) * BLOCK_SIZE);
+        for (size_t i = block * BLOCK_SIZE; i < end; ++i) {
+            data = DecodeTerm(data, term);
+            if (term.compare(0, prefix.size(), prefix) == 0) {
+                function(std::string_view{ term }, ids_[i]);
+            }
+            else if (std::string_view{ term } > prefix) {
+                return;
+            }
+        }
+    }
+}
+
+template <typename Automaton, typename Function>
+void FrontCodedTerms::ForEachAccepted(Automaton& automaton, Function function) const {
+    std::string term;
+    std::string target;
+    bool is_seeking = false;
+    for (size_t block = 0; block < block_offsets_.size(); ) {
+        const uint8_t* data = data_.data() + block_offsets_[block];
+        const size_t end = std::min(ids_.size(), (block + 1) * BLOCK_SIZE);
+        for (size_t i = block * BLOCK_SIZE; i < end; ++i) {
+            data = DecodeTerm(data, term);
+            if (is_seeking) {
+                if (term < target) {
+                    continue;
+                }
+                is_seeking = false;
+            }
+            if (automaton.Feed(term) > 0) {
+                if (!automaton.FindNextAlivePrefix(target)) {
+                    return;
+                }
+                is_seeking = true;
+            }
+            else if (automaton.IsAccepted()) {
+                function(std::string_view{ term }, ids_[i]);
+            }
+        }
+        // цель может быть много блоков дальше: следующий блок - последний, который начинается не позже неё
+        const size_t next_block = is_seeking ? FindBlockAfter(target, block) : block + 1;
+        block = std::max(block + 1, next_block - 1);
+    }
+}
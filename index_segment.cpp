@@ -0,0 +1,115 @@
+#include "index_segment.h"
+
+#include <algorithm>
+#include <utility>
+
+IndexSegment::IndexSegment(PostingFormat format)
+    : format_(format) {
+}
+
+IndexSegment::IndexSegment(std::vector<PostingList> postings, size_t document_count)
+    : postings_(std::move(postings))
+    , document_count_(document_count)
+    , format_(PostingFormat::PLAIN) {
+}
+
+const PostingList* IndexSegment::FindPostings(TermDictionary::TermId term_id) const noexcept {
+    if (term_id >= postings_.size() || postings_[term_id].empty()) {
+        return nullptr;
+    }
+    return &postings_[term_id];
+}
+
+PostingList& IndexSegment::GetPostings(TermDictionary::TermId term_id) {
+    return postings_[term_id];
+}
+
+void IndexSegment::Resize(size_t term_count) {
+    if (term_count > postings_.size()) {
+        postings_.resize(term_count, PostingList(format_));
+    }
+}
+
+size_t IndexSegment::GetTermCount() const noexcept {
+    return postings_.size();
+}
+
+void IndexSegment::SetDocumentCount(size_t document_count) noexcept {
+    document_count_ = document_count;
+}
+
+size_t IndexSegment::GetDocumentCount() const noexcept {
+    return document_count_;
+}
+
+void IndexSegment::SetFormat(PostingFormat format) {
+    format_ = format;
+    for (PostingList& postings : postings_) {
+        postings.SetFormat(format);
+    }
+}
+
+PostingFormat IndexSegment::GetFormat() const noexcept {
+    return format_;
+}
+
+IndexSegment IndexSegment::Merge(const std::vector<std::shared_ptr<const IndexSegment>>& segments,
+    const std::vector<uint64_t>& alive_documents, size_t document_count, PostingFormat format) {
+    IndexSegment result(format);
+    size_t term_count = 0;
+    for (const auto& segment : segments) {
+        term_count = std::max(term_count, segment->GetTermCount());
+    }
+    result.Resize(term_count);
+    result.SetDocumentCount(document_count);
+
+    std::vector<Posting> postings;
+    for (TermDictionary::TermId term_id = 0; term_id < term_count; ++term_id) {
+        postings.clear();
+        size_t source_count = 0;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            const PostingList* source = segments[i]->FindPostings(term_id);
+            if (source == nullptr) {
+                continue;
+            }
+            ++source_count;
+            for (PostingCursor cursor(*source); !cursor.IsEnd(); cursor.Next()) {
+                const size_t number = static_cast<size_t>(cursor->document_id);
+                if (number / 64 < alive_documents.size() && ((alive_documents[number / 64] >> (number % 64)) & 1)) {
+                    postings.push_back(*cursor);
+                }
+            }
+        }
+        // id документов разных сегментов перемежаются
+        if (source_count > 1) {
+            std::sort(postings.begin(), postings.end(), [](const Posting& lhs, const Posting& rhs) {
+                return lhs.document_id < rhs.document_id;
+            });
+        }
+        result.GetPostings(term_id).Merge(postings);
+    }
+    return result;
+}
+
+IndexSegment IndexSegment::Renumber(const IndexSegment& segment, const std::vector<int>& new_numbers,
+    size_t document_count, PostingFormat format) {
+    IndexSegment result(format);
+    result.Resize(segment.GetTermCount());
+    result.SetDocumentCount(document_count);
+
+    std::vector<Posting> postings;
+    for (TermDictionary::TermId term_id = 0; term_id < segment.GetTermCount(); ++term_id) {
+        const PostingList* source = segment.FindPostings(term_id);
+        if (source == nullptr) {
+            continue;
+        }
+        postings.clear();
+        for (PostingCursor cursor(*source); !cursor.IsEnd(); cursor.Next()) {
+            if (const int number = new_numbers[cursor->document_id]; number >= 0) {
+                postings.push_back({ number, cursor->term_freq });
+            }
+        }
+        result.GetPostings(term_id).Merge(postings);
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "posting_list.h"
+#include "term_dictionary.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Сегмент индекса: постинг-листы документов, добавленных за некоторый промежуток времени.
+// Каждый документ целиком лежит в одном сегменте, поэтому запрос к сегментам выполняется
+// независимо, а результаты просто объединяются. Запечатанные сегменты не изменяются
+// и могут читаться из фонового потока слияния.
+class IndexSegment {
+public:
+    explicit IndexSegment(PostingFormat format = PostingFormat::PLAIN);
+    IndexSegment(std::vector<PostingList> postings, size_t document_count);
+
+    // nullptr, если в сегменте нет постингов терма
+    [[nodiscard]] const PostingList* FindPostings(TermDictionary::TermId term_id) const noexcept;
+
+    // term_id должен быть меньше GetTermCount()
+    [[nodiscard]] PostingList& GetPostings(TermDictionary::TermId term_id);
+
+    void Resize(size_t term_count);
+    [[nodiscard]] size_t GetTermCount() const noexcept;
+
+    // документы, у которых есть постинги в сегменте
+    void SetDocumentCount(size_t document_count) noexcept;
+    [[nodiscard]] size_t GetDocumentCount() const noexcept;
+
+    void SetFormat(PostingFormat format);
+    [[nodiscard]] PostingFormat GetFormat() const noexcept;
+
+    // Сливает сегменты в один. В результат попадают только постинги документов, чей бит
+    // установлен в alive_documents (бит номера n - в слове n / 64); document_count - их число.
+    [[nodiscard]] static IndexSegment Merge(const std::vector<std::shared_ptr<const IndexSegment>>& segments,
+        const std::vector<uint64_t>& alive_documents, size_t document_count, PostingFormat format);
+
+    // Копия сегмента в новой нумерации: постинг номера n получает номер new_numbers[n], постинги номеров
+    // с -1 отбрасываются. Нумерация сохраняет порядок, поэтому постинг-листы остаются упорядоченными
+    [[nodiscard]] static IndexSegment Renumber(const IndexSegment& segment, const std::vector<int>& new_numbers,
+        size_t document_count, PostingFormat format);
+
+private:
+    std::vector<PostingList> postings_;
+    size_t document_count_ = 0;
+    PostingFormat format_;
+};
@@ -0,0 +1,194 @@
+#include "index_snapshot.h"
+
+#include <cstdio>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char SNAPSHOT_MAGIC[8] = { 'S', 'R', 'C', 'H', 'S', 'N', 'A', 'P' };
+    constexpr uint64_t BYTE_ORDER_MARK = 0x0102030405060708ull;
+    constexpr size_t ALIGNMENT = 8;
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t byte_order_mark;
+        uint64_t payload_size;
+        uint64_t checksum;
+    };
+    static_assert(sizeof(SnapshotHeader) % ALIGNMENT == 0, "payload must start aligned");
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw std::runtime_error(std::string{ "cannot open snapshot " } + path);
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file_);
+        throw std::runtime_error(std::string{ "cannot map snapshot " } + path);
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+        CloseHandle(file_);
+        throw std::runtime_error(std::string{ "cannot map snapshot " } + path);
+    }
+    data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw std::runtime_error(std::string{ "cannot map snapshot " } + path);
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(std::string{ "cannot open snapshot " } + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        throw std::runtime_error(std::string{ "cannot map snapshot " } + path);
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error(std::string{ "cannot map snapshot " } + path);
+    }
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<size_t>(file_stat.st_size);
+}
+
+MappedFile::~MappedFile() {
+    munmap(const_cast<char*>(data_), size_);
+}
+#endif
+
+const char* MappedFile::data() const noexcept {
+    return data_;
+}
+
+size_t MappedFile::size() const noexcept {
+    return size_;
+}
+
+uint64_t ComputeSnapshotChecksum(const char* data, size_t size) noexcept {
+    // FNV-1a по 8 байт за шаг: в разы быстрее побайтового и достаточно для поиска повреждений
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void SnapshotWriter::WriteBytes(std::string_view bytes) {
+    payload_.append(bytes.data(), bytes.size());
+}
+
+void SnapshotWriter::Align() {
+    payload_.append((ALIGNMENT - payload_.size() % ALIGNMENT) % ALIGNMENT, '\0');
+}
+
+void SnapshotWriter::SaveToFile(const std::string& path) const {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_FORMAT_VERSION;
+    header.byte_order_mark = BYTE_ORDER_MARK;
+    header.payload_size = payload_.size();
+    header.checksum = ComputeSnapshotChecksum(payload_.data(), payload_.size());
+
+    // пишем во временный файл и переименовываем, чтобы не оставить полузаписанный снимок
+    const std::string temp_path = path + std::string{ ".tmp" };
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload_.data(), static_cast<std::streamsize>(payload_.size()));
+        if (!out) {
+            throw std::runtime_error(std::string{ "cannot write snapshot " } + temp_path);
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error(std::string{ "cannot write snapshot " } + path);
+    }
+}
+
+SnapshotReader::SnapshotReader(const MappedFile& file)
+    : data_(file.data())
+    , size_(file.size())
+    , position_(sizeof(SnapshotHeader))
+{
+    if (size_ < sizeof(SnapshotHeader)) {
+        throw std::runtime_error(std::string{ "snapshot is truncated" });
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error(std::string{ "file is not a search server snapshot" });
+    }
+    if (header.version != SNAPSHOT_FORMAT_VERSION) {
+        throw std::runtime_error(std::string{ "unsupported snapshot version " } + std::to_string(header.version));
+    }
+    if (header.byte_order_mark != BYTE_ORDER_MARK) {
+        throw std::runtime_error(std::string{ "snapshot was written on a machine with another byte order" });
+    }
+    if (header.payload_size != size_ - sizeof(SnapshotHeader)) {
+        throw std::runtime_error(std::string{ "snapshot is truncated" });
+    }
+    if (header.checksum != ComputeSnapshotChecksum(data_ + sizeof(SnapshotHeader), header.payload_size)) {
+        throw std::runtime_error(std::string{ "snapshot checksum mismatch" });
+    }
+}
+
+std::string_view SnapshotReader::ReadBytes(size_t size) {
+    Require(size);
+    const std::string_view bytes(data_ + position_, size);
+    position_ += size;
+    return bytes;
+}
+
+void SnapshotReader::Align() {
+    // смещения считаются от начала файла, а он отображается с границы страницы
+    position_ += (ALIGNMENT - position_ % ALIGNMENT) % ALIGNMENT;
+    if (position_ > size_) {
+        throw std::runtime_error(std::string{ "snapshot is truncated" });
+    }
+}
+
+bool SnapshotReader::IsEnd() const noexcept {
+    return position_ == size_;
+}
+
+void SnapshotReader::Require(size_t size) const {
+    if (size > size_ - position_) {
+        throw std::runtime_error(std::string{ "snapshot is truncated" });
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] const char* data() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+// Формат снимка: заголовок (магия, версия, порядок байт, размер и контрольная сумма
+// полезной нагрузки), затем секции. Массивы выровнены на 8 байт относительно начала файла,
+// поэтому их можно читать прямо из отображения без копирования.
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 5;
+
+[[nodiscard]] uint64_t ComputeSnapshotChecksum(const char* data, size_t size) noexcept;
+
+class SnapshotWriter {
+public:
+    template <typename T>
+    void Write(const T& value);
+
+    template <typename T>
+    void WriteArray(const T* values, size_t count);
+
+    void WriteBytes(std::string_view bytes);
+
+    void Align();
+
+    void SaveToFile(const std::string& path) const;
+
+private:
+    std::string payload_;
+};
+
+class SnapshotReader {
+public:
+    // проверяет заголовок и контрольную сумму
+    explicit SnapshotReader(const MappedFile& file);
+
+    template <typename T>
+    [[nodiscard]] T Read();
+
+    // указатель прямо в отображение файла
+    template <typename T>
+    [[nodiscard]] const T* ReadArray(size_t count);
+
+    [[nodiscard]] std::string_view ReadBytes(size_t size);
+
+    void Align();
+
+    [[nodiscard]] bool IsEnd() const noexcept;
+
+private:
+    void Require(size_t size) const;
+
+    const char* data_;
+    size_t size_;
+    size_t position_;
+};
+
+template <typename T>
+void SnapshotWriter::Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+    payload_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void SnapshotWriter::WriteArray(const T* values, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+    Align();
+    payload_.append(reinterpret_cast<const char*>(values), sizeof(T) * count);
+}
+
+template <typename T>
+T SnapshotReader::Read() {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+    Require(sizeof(T));
+    T value;
+    std::memcpy(&value, data_ + position_, sizeof(T));
+    position_ += sizeof(T);
+    return value;
+}
+
+template <typename T>
+const T* SnapshotReader::ReadArray(size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+    static_assert(alignof(T) <= 8, "snapshot arrays are 8-byte aligned");
+    Align();
+    if (count > size_ / sizeof(T)) {
+        throw std::runtime_error(std::string{ "snapshot is truncated" });
+    }
+    Require(sizeof(T) * count);
+    const T* values = reinterpret_cast<const T*>(data_ + position_);
+    position_ += sizeof(T) * count;
+    return values;
+}
@@ -0,0 +1,45 @@
+#include "inverse_document_freqs.h"
+
+#include <cmath>
+
+InverseDocumentFreqs::InverseDocumentFreqs(IdfConsistency consistency)
+    : consistency_(consistency)
+{
+}
+
+IdfConsistency InverseDocumentFreqs::GetConsistency() const noexcept {
+    return consistency_;
+}
+
+void InverseDocumentFreqs::SetDocumentCount(int document_count) {
+    document_count_ = document_count;
+    log_document_count_ = document_count > 0 ? std::log(static_cast<double>(document_count)) : 0.0;
+}
+
+void InverseDocumentFreqs::Reserve(size_t term_count) {
+    if (consistency_ == IdfConsistency::INCREMENTAL && log_document_freqs_.size() < term_count) {
+        log_document_freqs_.resize(term_count, 0.0);
+    }
+}
+
+void InverseDocumentFreqs::SetDocumentFreq(TermDictionary::TermId term_id, size_t document_freq) {
+    if (consistency_ == IdfConsistency::INCREMENTAL) {
+        log_document_freqs_[term_id] = document_freq > 0 ? std::log(static_cast<double>(document_freq)) : 0.0;
+    }
+}
+
+double InverseDocumentFreqs::Get(TermDictionary::TermId term_id, size_t document_freq) const {
+    if (consistency_ == IdfConsistency::EXACT) {
+        return std::log(document_count_ * 1.0 / document_freq);
+    }
+    return log_document_count_ - log_document_freqs_[term_id];
+}
+
+double InverseDocumentFreqs::Compute(IdfConsistency consistency, int document_count, size_t document_freq) {
+    if (consistency == IdfConsistency::EXACT) {
+        return std::log(document_count * 1.0 / document_freq);
+    }
+    const double log_document_count = document_count > 0 ? std::log(static_cast<double>(document_count)) : 0.0;
+    const double log_document_freq = document_freq > 0 ? std::log(static_cast<double>(document_freq)) : 0.0;
+    return log_document_count - log_document_freq;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "term_dictionary.h"
+
+#include <cstddef>
+#include <vector>
+
+enum class IdfConsistency {
+    // log(N / df) считается заново для каждого слова запроса
+    EXACT,
+    // log(df) хранится по термам и обновляется вместе с df, log(N) - вместе с числом документов;
+    // запрос читает idf = log(N) - log(df) без вызова log
+    INCREMENTAL,
+};
+
+// IDF термов индекса. Изменяется только пишущим потоком (AddDocument/RemoveDocument),
+// чтение из запросов не модифицирует состояние, поэтому безопасно из нескольких потоков.
+class InverseDocumentFreqs {
+public:
+    explicit InverseDocumentFreqs(IdfConsistency consistency = IdfConsistency::INCREMENTAL);
+
+    [[nodiscard]] IdfConsistency GetConsistency() const noexcept;
+
+    void SetDocumentCount(int document_count);
+
+    // разные term_id можно обновлять параллельно, если место под них уже выделено Reserve
+    void Reserve(size_t term_count);
+    void SetDocumentFreq(TermDictionary::TermId term_id, size_t document_freq);
+
+    [[nodiscard]] double Get(TermDictionary::TermId term_id, size_t document_freq) const;
+
+    // IDF по числу документов и df, точно такой же, как Get сервера в режиме consistency
+    [[nodiscard]] static double Compute(IdfConsistency consistency, int document_count, size_t document_freq);
+
+private:
+    IdfConsistency consistency_;
+    int document_count_ = 0;
+    double log_document_count_ = 0.0;
+    std::vector<double> log_document_freqs_;
+};
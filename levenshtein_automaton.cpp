@@ -0,0 +1,120 @@
+#include "levenshtein_automaton.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view word, size_t max_distance)
+    : word_(word) {
+    // значения строк хранятся в байте вместе с пределом max_distance + 1
+    if (max_distance >= UINT8_MAX - 1) {
+        throw std::invalid_argument(std::string{ "edit distance is too large" });
+    }
+    max_distance_ = static_cast<uint8_t>(max_distance);
+    for (const char c : word_) {
+        is_word_char_[static_cast<unsigned char>(c)] = true;
+    }
+    for (unsigned c = 0; c <= UCHAR_MAX; ++c) {
+        if (is_word_char_[c]) {
+            word_chars_.push_back(static_cast<unsigned char>(c));
+        }
+    }
+    rows_.resize(word_.size() + 1);
+    for (size_t j = 0; j <= word_.size(); ++j) {
+        rows_[j] = static_cast<uint8_t>(std::min<size_t>(j, max_distance_ + 1));
+    }
+}
+
+size_t LevenshteinAutomaton::Feed(std::string_view term) {
+    size_t shared = 0;
+    const size_t max_shared = std::min(depth_, term.size());
+    while (shared < max_shared && path_[shared] == term[shared]) {
+        ++shared;
+    }
+    depth_ = shared;
+    path_.resize(shared);
+    is_complete_ = false;
+    // общий префикс мог закончиться мёртвым состоянием, если прошлый term на нём остановился
+    if (IsDead(depth_)) {
+        return depth_;
+    }
+    while (depth_ < term.size()) {
+        const int min_value = ComputeNextRow(term[depth_]);
+        path_.push_back(term[depth_]);
+        ++depth_;
+        if (min_value > max_distance_) {
+            return depth_;
+        }
+    }
+    is_complete_ = true;
+    return 0;
+}
+
+bool LevenshteinAutomaton::IsAccepted() const noexcept {
+    return is_complete_ && GetRow(depth_)[word_.size()] <= max_distance_;
+}
+
+size_t LevenshteinAutomaton::GetDistance() const noexcept {
+    return GetRow(depth_)[word_.size()];
+}
+
+bool LevenshteinAutomaton::FindNextAlivePrefix(std::string& prefix) {
+    is_complete_ = false;
+    // последний символ мёртвого префикса заменяется следующими по порядку, а если живых среди них
+    // нет - отбрасывается, и то же повторяется уровнем выше. Состояния более коротких префиксов живые
+    while (depth_ > 0) {
+        const unsigned last = static_cast<unsigned char>(path_.back());
+        path_.pop_back();
+        --depth_;
+        // кандидаты по возрастанию: символы word и наименьший из прочих символов - за него
+        // отвечают все остальные
+        unsigned other_char = last + 1;
+        while (other_char <= UCHAR_MAX && is_word_char_[other_char]) {
+            ++other_char;
+        }
+        auto word_char = std::upper_bound(word_chars_.begin(), word_chars_.end(), last);
+        while (word_char != word_chars_.end() || other_char <= UCHAR_MAX) {
+            unsigned c = 0;
+            if (word_char != word_chars_.end() && *word_char < other_char) {
+                c = *word_char++;
+            }
+            else {
+                c = other_char;
+                other_char = UCHAR_MAX + 1;
+            }
+            if (ComputeNextRow(static_cast<char>(c)) <= max_distance_) {
+                path_.push_back(static_cast<char>(c));
+                ++depth_;
+                prefix = path_;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const uint8_t* LevenshteinAutomaton::GetRow(size_t depth) const noexcept {
+    return rows_.data() + depth * (word_.size() + 1);
+}
+
+bool LevenshteinAutomaton::IsDead(size_t depth) const noexcept {
+    const uint8_t* row = GetRow(depth);
+    return *std::min_element(row, row + word_.size() + 1) > max_distance_;
+}
+
+int LevenshteinAutomaton::ComputeNextRow(char c) {
+    const size_t width = word_.size() + 1;
+    if (rows_.size() < (depth_ + 2) * width) {
+        rows_.resize((depth_ + 2) * width);
+    }
+    const int limit = max_distance_ + 1;
+    const uint8_t* row = rows_.data() + depth_ * width;
+    uint8_t* next = rows_.data() + (depth_ + 1) * width;
+    next[0] = static_cast<uint8_t>(std::min(row[0] + 1, limit));
+    int min_value = next[0];
+    for (size_t j = 1; j < width; ++j) {
+        const int value = std::min({ row[j - 1] + (word_[j - 1] == c ? 0 : 1), row[j] + 1, next[j - 1] + 1, limit });
+        next[j] = static_cast<uint8_t>(value);
+        min_value = std::min(min_value, value);
+    }
+    return min_value;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Автомат Левенштейна: принимает строки на расстоянии редактирования не больше max_distance от word.
+// Состояние после прочитанного префикса - строка таблицы динамики (расстояния от префикса до каждого
+// префикса word), значения ограничены max_distance + 1. Состояние мёртвое, если все значения больше
+// max_distance: тогда ни одно продолжение префикса не принимается. Обход упорядоченного словаря
+// не читает такие термы: автомат сам называет следующий живой префикс, и словарь перескакивает к нему.
+// Строки хранятся по глубине, поэтому у соседних термов общий префикс заново не читается.
+class LevenshteinAutomaton {
+public:
+    LevenshteinAutomaton(std::string_view word, size_t max_distance);
+
+    // Читает term с начала, переиспользуя состояния общего префикса с прошлым term.
+    // Возвращает длину кратчайшего префикса term, после которого автомат мёртв, или 0, если такого нет
+    [[nodiscard]] size_t Feed(std::string_view term);
+
+    // прошлый term прочитан целиком и принят
+    [[nodiscard]] bool IsAccepted() const noexcept;
+    // расстояние от прошлого принятого term до word
+    [[nodiscard]] size_t GetDistance() const noexcept;
+
+    // После Feed, остановившегося на мёртвом префиксе: пишет в prefix наименьшую строку больше всех
+    // строк с этим префиксом, после которой автомат жив. false, если такой строки нет
+    [[nodiscard]] bool FindNextAlivePrefix(std::string& prefix);
+
+private:
+    [[nodiscard]] const uint8_t* GetRow(size_t depth) const noexcept;
+    [[nodiscard]] bool IsDead(size_t depth) const noexcept;
+    // строка после path_ + c на глубине depth_ + 1; возвращает её наименьшее значение
+    int ComputeNextRow(char c);
+
+    std::string word_;
+    uint8_t max_distance_;
+    // символы, не входящие в word, для автомата неотличимы
+    std::array<bool, UCHAR_MAX + 1> is_word_char_{};
+    // различные символы word по возрастанию
+    std::vector<unsigned char> word_chars_;
+    // строки таблицы для префиксов path_ длиной 0..depth_ подряд, по word_.size() + 1 значений
+    std::vector<uint8_t> rows_;
+    std::string path_;
+    size_t depth_ = 0;
+    // прошлый term прочитан целиком, без остановки на мёртвом префиксе
+    bool is_complete_ = false;
+};
@@ -1,52 +1,52 @@
-#include "process_queries.h"
-#include "search_server.h"
-
-#include <execution>
-#include <iostream>
-#include <string>
-#include <vector>
-
-using namespace std;
-
-//void PrintDocument(const Document& document) {
-//    cout << "{ "s
-//        << "document_id = "s << document.id << ", "s
-//        << "relevance = "s << document.relevance << ", "s
-//        << "rating = "s << document.rating << " }"s << endl;
-//}
-
-int main() {
-    SearchServer search_server("and with"s);
-
-    int id = 0;
-    for (
-        const string& text : {
-            "white cat and yellow hat"s,
-            "curly cat curly tail"s,
-            "nasty dog with big eyes"s,
-            "nasty pigeon john"s,
-        }
-        ) {
-        search_server.AddDocument(++id, text, DocumentStatus::ACTUAL, { 1, 2 });
-    }
-
-
-    cout << "ACTUAL by default:"s << endl;
-    //  
-    for (const Document& document : search_server.FindTopDocuments("curly nasty cat"s)) {
-        cout << document << endl;
-    }
-    cout << "BANNED:"s << endl;
-    //  
-    for (const Document& document : search_server.FindTopDocuments(execution::seq, "curly nasty cat"s, DocumentStatus::BANNED)) {
-        cout << document << endl;
-    }
-
-    cout << "Even ids:"s << endl;
-    //  
-    for (const Document& document : search_server.FindTopDocuments(execution::par, "curly nasty cat"s, [](int document_id, DocumentStatus status, int rating) { return document_id % 2 == 0; })) {
-        cout << document << endl;
-    }
-    system("pause");
-    return 0;
+#include "process_queries.h"
+#include "search_server.h"
+
+#include <execution>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//void PrintDocument(const Document& document) {
+//    cout << "{ "s
+//        << "document_id = "s << document.id << ", "s
+//        << "relevance = "s << document.relevance << ", "s
+//        << "rating = "s << document.rating << " }"s << endl;
+//}
+
+int main() {
+    SearchServer search_server("and with"s);
+
+    int id = 0;
+    for (
+        const string& text : {
+            "white cat and yellow hat"s,
+            "curly cat curly tail"s,
+            "nasty dog with big eyes"s,
+            "nasty pigeon john"s,
+        }
+        ) {
+        search_server.AddDocument(++id, text, DocumentStatus::ACTUAL, { 1, 2 });
+    }
+
+
+    cout << "ACTUAL by default:"s << endl;
+    // последовательная версия
+    for (const Document& document : search_server.FindTopDocuments("curly nasty cat"s)) {
+        cout << document << endl;
+    }
+    cout << "BANNED:"s << endl;
+    // последовательная версия
+    for (const Document& document : search_server.FindTopDocuments(execution::seq, "curly nasty cat"s, DocumentStatus::BANNED)) {
+        cout << document << endl;
+    }
+
+    cout << "Even ids:"s << endl;
+    // параллельная версия
+    for (const Document& document : search_server.FindTopDocuments(execution::par, "curly nasty cat"s, [](int document_id, DocumentStatus status, int rating) { return document_id % 2 == 0; })) {
+        cout << document << endl;
+    }
+    system("pause");
+    return 0;
 }
\ No newline at end of file
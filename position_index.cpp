@@ -0,0 +1,305 @@
+#include "position_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+    void WriteVarint(uint32_t value, std::vector<uint8_t>& data) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint32_t ReadVarint(const uint8_t*& data) noexcept {
+        uint32_t value = 0;
+        for (int shift = 0; ; shift += 7) {
+            const uint8_t byte = *data++;
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+
+    void DecodePositions(const uint8_t* first, const uint8_t* last, std::vector<uint32_t>& positions) {
+        positions.clear();
+        uint32_t position = 0;
+        while (first != last) {
+            position += ReadVarint(first);
+            positions.push_back(position);
+        }
+    }
+
+    // позиции одного терма, декодируемые по мере продвижения
+    class PositionCursor {
+    public:
+        // без инициализации: массив курсоров заводится на стеке при каждой проверке фразы
+        PositionCursor() = default;
+
+        PositionCursor(const uint8_t* first, const uint8_t* last) noexcept
+            : next_(first), last_(last), position_(0), is_end_(false) {
+            Next();
+        }
+
+        [[nodiscard]] bool IsEnd() const noexcept {
+            return is_end_;
+        }
+
+        [[nodiscard]] uint32_t Get() const noexcept {
+            return position_;
+        }
+
+        void Next() noexcept {
+            if (next_ == last_) {
+                is_end_ = true;
+            }
+            else {
+                position_ += ReadVarint(next_);
+            }
+        }
+
+        // к первой позиции >= position
+        void Seek(uint32_t position) noexcept {
+            while (!is_end_ && position_ < position) {
+                Next();
+            }
+        }
+
+    private:
+        const uint8_t* next_;
+        const uint8_t* last_;
+        uint32_t position_;
+        bool is_end_;
+    };
+}
+
+PositionIndex::DocumentPositions PositionIndex::Encode(std::vector<std::pair<TermDictionary::TermId, std::vector<uint32_t>>> term_positions) {
+    std::sort(term_positions.begin(), term_positions.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+    DocumentPositions result;
+    result.term_ids.reserve(term_positions.size());
+    result.offsets.reserve(term_positions.size() + 1);
+    for (const auto& [term_id, positions] : term_positions) {
+        uint32_t previous = 0;
+        for (const uint32_t position : positions) {
+            WriteVarint(position - previous, result.data);
+            previous = position;
+        }
+        result.term_ids.push_back(term_id);
+        result.offsets.push_back(static_cast<uint32_t>(result.data.size()));
+    }
+    return result;
+}
+
+void PositionIndex::Add(int document_number, DocumentPositions positions) {
+    if (document_number < 0) {
+        throw std::out_of_range(std::string{ "invalid document number" });
+    }
+    const size_t term_count = positions.term_ids.size();
+    if (positions.offsets.size() != term_count + 1 || positions.offsets.back() != positions.data.size()) {
+        throw std::invalid_argument(std::string{ "invalid document positions" });
+    }
+    Remove(document_number);
+    if (static_cast<size_t>(document_number) >= documents_.size()) {
+        documents_.resize(static_cast<size_t>(document_number) + 1);
+    }
+    const size_t data_size = (positions.data.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    BlockRange& range = documents_[document_number];
+    range.begin = blocks_.size();
+    range.size = static_cast<uint32_t>(2 * term_count + 2 + data_size);
+    blocks_.push_back(static_cast<uint32_t>(term_count));
+    blocks_.insert(blocks_.end(), positions.term_ids.begin(), positions.term_ids.end());
+    blocks_.insert(blocks_.end(), positions.offsets.begin(), positions.offsets.end());
+    blocks_.resize(blocks_.size() + data_size, 0);
+    std::copy(positions.data.begin(), positions.data.end(), reinterpret_cast<uint8_t*>(blocks_.data() + range.begin + 2 * term_count + 2));
+}
+
+void PositionIndex::Remove(int document_number) {
+    if (document_number < 0 || static_cast<size_t>(document_number) >= documents_.size()) {
+        return;
+    }
+    garbage_size_ += documents_[document_number].size;
+    documents_[document_number] = BlockRange{};
+    if (garbage_size_ * 2 > blocks_.size()) {
+        Compact();
+    }
+}
+
+void PositionIndex::Renumber(const std::vector<int>& new_numbers) {
+    std::vector<BlockRange> documents;
+    for (size_t document_number = 0; document_number < documents_.size() && document_number < new_numbers.size(); ++document_number) {
+        const int new_number = new_numbers[document_number];
+        if (new_number < 0) {
+            continue;
+        }
+        if (static_cast<size_t>(new_number) >= documents.size()) {
+            documents.resize(static_cast<size_t>(new_number) + 1);
+        }
+        documents[new_number] = documents_[document_number];
+    }
+    documents_ = std::move(documents);
+    if (garbage_size_ > 0) {
+        Compact();
+    }
+}
+
+void PositionIndex::Compact() {
+    std::vector<uint32_t> blocks;
+    blocks.reserve(blocks_.size() - garbage_size_);
+    for (BlockRange& range : documents_) {
+        const size_t begin = blocks.size();
+        blocks.insert(blocks.end(), blocks_.begin() + range.begin, blocks_.begin() + range.begin + range.size);
+        range.begin = begin;
+    }
+    blocks_ = std::move(blocks);
+    garbage_size_ = 0;
+}
+
+PositionIndex::DocumentPositions PositionIndex::Get(int document_number) const {
+    const DocumentView document = View(document_number);
+    DocumentPositions result;
+    result.term_ids.assign(document.term_ids, document.term_ids + document.term_count);
+    result.offsets.assign(document.offsets, document.offsets + document.term_count + 1);
+    result.data.assign(document.data, document.data + document.offsets[document.term_count]);
+    return result;
+}
+
+PositionIndex::DocumentView PositionIndex::View(int document_number) const noexcept {
+    static const uint32_t empty_offsets[1] = { 0 };
+    DocumentView result;
+    result.offsets = empty_offsets;
+    if (document_number < 0 || static_cast<size_t>(document_number) >= documents_.size() || documents_[document_number].size == 0) {
+        return result;
+    }
+    const uint32_t* block = blocks_.data() + documents_[document_number].begin;
+    result.term_count = block[0];
+    result.term_ids = block + 1;
+    result.offsets = block + 1 + result.term_count;
+    result.data = reinterpret_cast<const uint8_t*>(block + 2 * result.term_count + 2);
+    return result;
+}
+
+void PositionIndex::Prefetch(int document_number) const noexcept {
+#if defined(__GNUC__)
+    if (document_number >= 0 && static_cast<size_t>(document_number) < documents_.size()) {
+        __builtin_prefetch(blocks_.data() + documents_[document_number].begin);
+    }
+#else
+    (void)document_number;
+#endif
+}
+
+bool PositionIndex::FindPositions(int document_number, TermDictionary::TermId term_id, std::vector<uint32_t>& positions) const {
+    const DocumentView document = View(document_number);
+    const TermDictionary::TermId* term_ids_end = document.term_ids + document.term_count;
+    const TermDictionary::TermId* term = std::lower_bound(document.term_ids, term_ids_end, term_id);
+    if (term == term_ids_end || *term != term_id) {
+        positions.clear();
+        return false;
+    }
+    const size_t index = static_cast<size_t>(term - document.term_ids);
+    DecodePositions(document.data + document.offsets[index], document.data + document.offsets[index + 1], positions);
+    return true;
+}
+
+bool PositionIndex::ContainsPhrase(int document_number, const PhraseTerm* first, const PhraseTerm* last) const {
+    // Проверка идёт для каждого документа-кандидата, поэтому позиции не распаковываются в буферы:
+    // курсоры всех слов декодируют varint по мере того, как растёт проверяемое начало фразы
+    constexpr size_t INLINE_TERM_COUNT = 16;
+    const size_t term_count = static_cast<size_t>(last - first);
+    PositionCursor inline_cursors[INLINE_TERM_COUNT];
+    std::vector<PositionCursor> heap_cursors(term_count > INLINE_TERM_COUNT ? term_count : 0);
+    PositionCursor* cursors = term_count > INLINE_TERM_COUNT ? heap_cursors.data() : inline_cursors;
+
+    const DocumentView document = View(document_number);
+    const TermDictionary::TermId* term_ids_end = document.term_ids + document.term_count;
+    size_t rarest = 0;
+    uint32_t rarest_size = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < term_count; ++i) {
+        const TermDictionary::TermId* term = std::lower_bound(document.term_ids, term_ids_end, first[i].term_id);
+        if (term == term_ids_end || *term != first[i].term_id) {
+            return false;
+        }
+        const size_t index = static_cast<size_t>(term - document.term_ids);
+        const uint32_t size = document.offsets[index + 1] - document.offsets[index];
+        cursors[i] = PositionCursor(document.data + document.offsets[index], document.data + document.offsets[index + 1]);
+        if (size < rarest_size) {
+            rarest = i;
+            rarest_size = size;
+        }
+    }
+
+    // каждое вхождение самого редкого слова задаёт начало фразы, остальные слова ищутся на своих местах
+    for (PositionCursor& anchor = cursors[rarest]; !anchor.IsEnd(); anchor.Next()) {
+        if (anchor.Get() < first[rarest].offset) {
+            continue;
+        }
+        const uint32_t start = anchor.Get() - first[rarest].offset;
+        bool is_found = true;
+        for (size_t i = 0; i < term_count && is_found; ++i) {
+            if (i == rarest) {
+                continue;
+            }
+            cursors[i].Seek(start + first[i].offset);
+            if (cursors[i].IsEnd()) {
+                return false;
+            }
+            is_found = cursors[i].Get() == start + first[i].offset;
+        }
+        if (is_found) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t PositionIndex::FindMinSpan(int document_number, const std::vector<TermDictionary::TermId>& term_ids, size_t& matched_count) const {
+    thread_local std::vector<uint32_t> positions;
+    thread_local std::vector<std::pair<uint32_t, uint32_t>> occurrences;
+    occurrences.clear();
+    matched_count = 0;
+    for (const TermDictionary::TermId term_id : term_ids) {
+        if (FindPositions(document_number, term_id, positions)) {
+            for (const uint32_t position : positions) {
+                occurrences.emplace_back(position, static_cast<uint32_t>(matched_count));
+            }
+            ++matched_count;
+        }
+    }
+    if (matched_count == 0) {
+        return 0;
+    }
+    std::sort(occurrences.begin(), occurrences.end());
+
+    // скользящее окно по вхождениям: правая граница сдвигается, пока в окне не окажутся все термы,
+    // затем левая - пока они все в нём остаются
+    thread_local std::vector<uint32_t> window_counts;
+    window_counts.assign(matched_count, 0);
+    size_t covered_count = 0;
+    uint32_t min_span = std::numeric_limits<uint32_t>::max();
+    for (size_t left = 0, right = 0; right < occurrences.size(); ++right) {
+        if (window_counts[occurrences[right].second]++ == 0) {
+            ++covered_count;
+        }
+        while (covered_count == matched_count) {
+            min_span = std::min(min_span, occurrences[right].first - occurrences[left].first + 1);
+            if (--window_counts[occurrences[left].second] == 0) {
+                --covered_count;
+            }
+            ++left;
+        }
+    }
+    return min_span;
+}
+
+void PositionIndex::clear() noexcept {
+    blocks_.clear();
+    documents_.clear();
+    garbage_size_ = 0;
+}
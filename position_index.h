@@ -0,0 +1,78 @@
+#pragma once
+
+#include "term_dictionary.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Позиции слов в документах для фразового поиска и близости слов. Позиция - номер слова
+// в тексте документа; стоп-слова в индекс не попадают, но позиции занимают, поэтому фраза
+// со стоп-словами находится с теми же промежутками между словами. Для каждого документа хранятся
+// его термы по возрастанию id и позиции каждого терма, сжатые разностями в varint. Блоки документов
+// лежат в общем массиве подряд по номерам, так что проверка фраз в кандидатах, идущих по возрастанию
+// номеров, читает память вперёд, а не прыгает по куче.
+class PositionIndex {
+public:
+    struct DocumentPositions {
+        std::vector<TermDictionary::TermId> term_ids;
+        // позиции term_ids[i] занимают байты data[offsets[i], offsets[i + 1])
+        std::vector<uint32_t> offsets{ 0 };
+        std::vector<uint8_t> data;
+    };
+
+    // слово фразы: терм и его позиция относительно начала фразы
+    struct PhraseTerm {
+        TermDictionary::TermId term_id;
+        uint32_t offset;
+    };
+
+    // term_positions - позиции по возрастанию для каждого терма документа, термы в любом порядке
+    [[nodiscard]] static DocumentPositions Encode(std::vector<std::pair<TermDictionary::TermId, std::vector<uint32_t>>> term_positions);
+
+    void Add(int document_number, DocumentPositions positions);
+    void Remove(int document_number);
+    // документ с номером n получает номер new_numbers[n]; нумерация сохраняет порядок,
+    // документы с -1 должны быть уже удалены
+    void Renumber(const std::vector<int>& new_numbers);
+    [[nodiscard]] DocumentPositions Get(int document_number) const;
+
+    // позиции терма в документе по возрастанию; false, если терма в документе нет
+    bool FindPositions(int document_number, TermDictionary::TermId term_id, std::vector<uint32_t>& positions) const;
+
+    // подсказка процессору заранее подтянуть в кэш позиции документа, который скоро будет проверяться
+    void Prefetch(int document_number) const noexcept;
+
+    // слова [first, last) стоят в документе на своих местах относительно друг друга
+    [[nodiscard]] bool ContainsPhrase(int document_number, const PhraseTerm* first, const PhraseTerm* last) const;
+
+    // Длина наименьшего окна слов, в котором встречаются все термы term_ids, которые есть в документе;
+    // matched_count - число таких термов. Повторы в term_ids не допускаются
+    [[nodiscard]] uint32_t FindMinSpan(int document_number, const std::vector<TermDictionary::TermId>& term_ids, size_t& matched_count) const;
+
+    void clear() noexcept;
+
+private:
+    struct DocumentView {
+        uint32_t term_count = 0;
+        const TermDictionary::TermId* term_ids = nullptr;
+        const uint32_t* offsets = nullptr;
+        const uint8_t* data = nullptr;
+    };
+
+    struct BlockRange {
+        size_t begin = 0;
+        uint32_t size = 0;
+    };
+
+    [[nodiscard]] DocumentView View(int document_number) const noexcept;
+    // переписывает живые блоки подряд, когда удалённые занимают больше половины массива
+    void Compact();
+
+    // блок документа: число термов n, n id термов, n + 1 смещений, затем байты позиций
+    std::vector<uint32_t> blocks_;
+    std::vector<BlockRange> documents_;
+    size_t garbage_size_ = 0;
+};
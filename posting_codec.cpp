@@ -0,0 +1,153 @@
+#include "posting_codec.h"
+#include "posting_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POSTING_CODEC_SSE2
+#endif
+
+namespace {
+    constexpr size_t LANE_COUNT = 4;
+    constexpr size_t VALUES_PER_LANE = POSTING_BLOCK_SIZE / LANE_COUNT;
+
+    uint32_t GetBitWidth(uint32_t value) {
+        uint32_t bit_width = 0;
+        while (bit_width < 32 && (value >> bit_width) != 0) {
+            ++bit_width;
+        }
+        return bit_width;
+    }
+
+    void PackValues(const uint32_t* values, uint32_t bit_width, uint32_t* packed) {
+        for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            uint64_t accumulator = 0;
+            uint32_t accumulated_bits = 0;
+            size_t word = 0;
+            for (size_t i = 0; i < VALUES_PER_LANE; ++i) {
+                accumulator |= static_cast<uint64_t>(values[i * LANE_COUNT + lane]) << accumulated_bits;
+                accumulated_bits += bit_width;
+                if (accumulated_bits >= 32) {
+                    packed[word * LANE_COUNT + lane] = static_cast<uint32_t>(accumulator);
+                    accumulator >>= 32;
+                    accumulated_bits -= 32;
+                    ++word;
+                }
+            }
+        }
+    }
+
+    // распаковывает 128 значений по bit_width бит (1..32)
+    void UnpackValues(const uint32_t* packed, uint32_t bit_width, uint32_t* values) {
+#ifdef POSTING_CODEC_SSE2
+        const __m128i* input = reinterpret_cast<const __m128i*>(packed);
+        const __m128i mask = _mm_set1_epi32(bit_width == 32 ? -1 : static_cast<int>((1u << bit_width) - 1));
+        __m128i word = _mm_loadu_si128(input++);
+        uint32_t shift = 0;
+        for (size_t i = 0; i < VALUES_PER_LANE; ++i) {
+            __m128i value = _mm_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(shift)));
+            shift += bit_width;
+            if (shift >= 32 && i + 1 < VALUES_PER_LANE) {
+                shift -= 32;
+                word = _mm_loadu_si128(input++);
+                if (shift > 0) {
+                    value = _mm_or_si128(value, _mm_sll_epi32(word, _mm_cvtsi32_si128(static_cast<int>(bit_width - shift))));
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * LANE_COUNT), _mm_and_si128(value, mask));
+        }
+#else
+        const uint32_t mask = bit_width == 32 ? UINT32_MAX : (1u << bit_width) - 1;
+        uint32_t word[LANE_COUNT];
+        std::memcpy(word, packed, sizeof(word));
+        packed += LANE_COUNT;
+        uint32_t shift = 0;
+        for (size_t i = 0; i < VALUES_PER_LANE; ++i) {
+            uint32_t value[LANE_COUNT];
+            for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                value[lane] = shift < 32 ? word[lane] >> shift : 0;
+            }
+            shift += bit_width;
+            if (shift >= 32 && i + 1 < VALUES_PER_LANE) {
+                shift -= 32;
+                std::memcpy(word, packed, sizeof(word));
+                packed += LANE_COUNT;
+                if (shift > 0) {
+                    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                        value[lane] |= word[lane] << (bit_width - shift);
+                    }
+                }
+            }
+            for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+                values[i * LANE_COUNT + lane] = value[lane] & mask;
+            }
+        }
+#endif
+    }
+
+    // id = previous + 1 + gap, префиксная сумма по 4 значения за шаг
+    void RestoreDocumentIds(uint32_t* values, int previous_document_id) {
+#ifdef POSTING_CODEC_SSE2
+        const __m128i one = _mm_set1_epi32(1);
+        __m128i carry = _mm_set1_epi32(previous_document_id);
+        for (size_t i = 0; i < POSTING_BLOCK_SIZE; i += LANE_COUNT) {
+            __m128i value = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), one);
+            value = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+            value = _mm_add_epi32(value, _mm_slli_si128(value, 8));
+            value = _mm_add_epi32(value, carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), value);
+            carry = _mm_shuffle_epi32(value, 0xFF);
+        }
+#else
+        uint32_t document_id = static_cast<uint32_t>(previous_document_id);
+        for (size_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+            document_id += values[i] + 1;
+            values[i] = document_id;
+        }
+#endif
+    }
+}
+
+PostingBlock EncodePostingBlock(const Posting* postings, int previous_document_id, std::vector<uint32_t>& data) {
+    uint32_t gaps[POSTING_BLOCK_SIZE];
+    uint32_t max_gap = 0;
+    for (size_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+        gaps[i] = static_cast<uint32_t>(postings[i].document_id) - static_cast<uint32_t>(previous_document_id) - 1;
+        previous_document_id = postings[i].document_id;
+        max_gap = std::max(max_gap, gaps[i]);
+    }
+
+    const PostingBlock block{ previous_document_id, GetBitWidth(max_gap), static_cast<uint32_t>(data.size()) };
+    data.resize(data.size() + block.bit_width * LANE_COUNT + POSTING_BLOCK_SIZE);
+    uint32_t* output = data.data() + block.data_offset;
+    if (block.bit_width > 0) {
+        PackValues(gaps, block.bit_width, output);
+    }
+    output += block.bit_width * LANE_COUNT;
+    for (size_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+        const float term_freq = static_cast<float>(postings[i].term_freq);
+        std::memcpy(output + i, &term_freq, sizeof(term_freq));
+    }
+    return block;
+}
+
+void DecodePostingBlock(const PostingBlock& block, int previous_document_id, const uint32_t* data, Posting* postings) {
+    uint32_t document_ids[POSTING_BLOCK_SIZE];
+    const uint32_t* input = data + block.data_offset;
+    if (block.bit_width == 0) {
+        std::fill(std::begin(document_ids), std::end(document_ids), 0u);
+    }
+    else {
+        UnpackValues(input, block.bit_width, document_ids);
+    }
+    RestoreDocumentIds(document_ids, previous_document_id);
+
+    float term_freqs[POSTING_BLOCK_SIZE];
+    std::memcpy(term_freqs, input + block.bit_width * LANE_COUNT, sizeof(term_freqs));
+    for (size_t i = 0; i < POSTING_BLOCK_SIZE; ++i) {
+        postings[i].document_id = static_cast<int>(document_ids[i]);
+        postings[i].term_freq = term_freqs[i];
+    }
+}
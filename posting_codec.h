@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Сжатый блок постинг-листа: POSTING_BLOCK_SIZE постингов. Разности соседних id (минус 1)
+// упакованы по bit_width бит в вертикальной раскладке на 4 линии (как в SIMD-BP128):
+// значение i лежит в линии i % 4, и одна 128-битная загрузка даёт сразу 4 соседних значения.
+// За упакованными разностями идут tf, квантованные до float.
+constexpr size_t POSTING_BLOCK_SIZE = 128;
+
+struct PostingBlock {
+    int last_document_id;
+    uint32_t bit_width;
+    uint32_t data_offset;
+};
+
+struct Posting;
+
+// previous_document_id - последний id предыдущего блока (-1 для первого)
+[[nodiscard]] PostingBlock EncodePostingBlock(const Posting* postings, int previous_document_id, std::vector<uint32_t>& data);
+
+void DecodePostingBlock(const PostingBlock& block, int previous_document_id, const uint32_t* data, Posting* postings);
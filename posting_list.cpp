@@ -0,0 +1,238 @@
+#include "posting_list.h"
+
+#include <algorithm>
+
+namespace {
+    bool PostingLess(const Posting& posting, int document_id) {
+        return posting.document_id < document_id;
+    }
+
+    // галопирующий поиск первого постинга с id >= document_id, начиная с first
+    const Posting* SeekPosting(const Posting* first, const Posting* last, int document_id) {
+        ptrdiff_t step = 1;
+        while (step < last - first && (first + step)->document_id < document_id) {
+            first += step;
+            step *= 2;
+        }
+        return std::lower_bound(first, first + std::min(step + 1, last - first), document_id, PostingLess);
+    }
+}
+
+PostingList::PostingList(PostingFormat format)
+    : format_(format) {
+}
+
+PostingList PostingList::View(const Posting* postings, size_t size, double max_term_freq) {
+    PostingList result;
+    result.view_ = postings;
+    result.view_size_ = size;
+    result.max_term_freq_ = max_term_freq;
+    return result;
+}
+
+void PostingList::Insert(int document_id, double term_freq) {
+    // документы обычно добавляются по возрастанию id, поэтому чаще всего это добавление в хвост
+    const bool is_append = GetTailSize() > 0 ? GetTail()[GetTailSize() - 1].document_id < document_id
+        : blocks_.empty() || blocks_.back().last_document_id < document_id;
+    if (is_append && !IsView()) {
+        postings_.push_back({ document_id, term_freq });
+        max_term_freq_ = std::max(max_term_freq_, term_freq);
+        SealBlocks();
+        return;
+    }
+    std::vector<Posting>& postings = GetOwnPostings();
+    auto iter = std::lower_bound(postings.begin(), postings.end(), document_id, PostingLess);
+    if (iter != postings.end() && iter->document_id == document_id) {
+        iter->term_freq += term_freq;
+    }
+    else {
+        iter = postings.insert(iter, { document_id, term_freq });
+    }
+    max_term_freq_ = std::max(max_term_freq_, iter->term_freq);
+    SealBlocks();
+}
+
+void PostingList::Merge(const std::vector<Posting>& new_postings) {
+    if (new_postings.empty()) {
+        return;
+    }
+    std::vector<Posting>& postings = GetOwnPostings();
+    const size_t old_size = postings.size();
+    postings.insert(postings.end(), new_postings.begin(), new_postings.end());
+    if (old_size > 0 && postings[old_size - 1].document_id > new_postings.front().document_id) {
+        std::inplace_merge(postings.begin(), postings.begin() + old_size, postings.end(), [](const Posting& lhs, const Posting& rhs) {
+            return lhs.document_id < rhs.document_id;
+        });
+    }
+    for (const Posting& posting : new_postings) {
+        max_term_freq_ = std::max(max_term_freq_, posting.term_freq);
+    }
+    SealBlocks();
+}
+
+bool PostingList::Erase(int document_id) {
+    if (!Contains(document_id)) {
+        return false;
+    }
+    std::vector<Posting>& postings = GetOwnPostings();
+    postings.erase(std::lower_bound(postings.begin(), postings.end(), document_id, PostingLess));
+    SealBlocks();
+    return true;
+}
+
+bool PostingList::Contains(int document_id) const {
+    // без курсора: он выделяет буфер блока в куче, а Contains зовётся на каждый удаляемый документ
+    const auto block = std::lower_bound(blocks_.begin(), blocks_.end(), document_id, [](const PostingBlock& block, int id) {
+        return block.last_document_id < id;
+    });
+    if (block != blocks_.end()) {
+        Posting postings[POSTING_BLOCK_SIZE];
+        const int previous_document_id = block == blocks_.begin() ? -1 : (block - 1)->last_document_id;
+        DecodePostingBlock(*block, previous_document_id, block_data_.data(), postings);
+        const Posting* found = std::lower_bound(postings, postings + POSTING_BLOCK_SIZE, document_id, PostingLess);
+        return found != postings + POSTING_BLOCK_SIZE && found->document_id == document_id;
+    }
+    const Posting* const tail_end = GetTail() + GetTailSize();
+    const Posting* found = std::lower_bound(GetTail(), tail_end, document_id, PostingLess);
+    return found != tail_end && found->document_id == document_id;
+}
+
+void PostingList::SetFormat(PostingFormat format) {
+    format_ = format;
+    if (format == PostingFormat::PLAIN) {
+        if (!blocks_.empty()) {
+            GetOwnPostings();
+            block_data_.shrink_to_fit();
+            blocks_.shrink_to_fit();
+        }
+        return;
+    }
+    GetOwnPostings();
+    SealBlocks();
+    postings_.shrink_to_fit();
+    block_data_.shrink_to_fit();
+    blocks_.shrink_to_fit();
+}
+
+PostingFormat PostingList::GetFormat() const noexcept {
+    return format_;
+}
+
+double PostingList::GetMaxTermFreq() const noexcept {
+    return max_term_freq_;
+}
+
+bool PostingList::IsView() const noexcept {
+    return view_ != nullptr;
+}
+
+size_t PostingList::GetMemoryUsage() const noexcept {
+    return postings_.capacity() * sizeof(Posting) + blocks_.capacity() * sizeof(PostingBlock)
+        + block_data_.capacity() * sizeof(uint32_t);
+}
+
+size_t PostingList::size() const noexcept {
+    return blocks_.size() * POSTING_BLOCK_SIZE + GetTailSize();
+}
+
+bool PostingList::empty() const noexcept {
+    return size() == 0;
+}
+
+std::vector<Posting>& PostingList::GetOwnPostings() {
+    if (IsView()) {
+        postings_.assign(view_, view_ + view_size_);
+        view_ = nullptr;
+        view_size_ = 0;
+    }
+    if (!blocks_.empty()) {
+        std::vector<Posting> postings(size());
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            DecodePostingBlock(blocks_[i], i == 0 ? -1 : blocks_[i - 1].last_document_id, block_data_.data(),
+                postings.data() + i * POSTING_BLOCK_SIZE);
+        }
+        std::copy(postings_.begin(), postings_.end(), postings.begin() + blocks_.size() * POSTING_BLOCK_SIZE);
+        postings_ = std::move(postings);
+        blocks_.clear();
+        block_data_.clear();
+    }
+    return postings_;
+}
+
+void PostingList::SealBlocks() {
+    if (format_ != PostingFormat::COMPRESSED || postings_.size() < POSTING_BLOCK_SIZE) {
+        return;
+    }
+    size_t sealed = 0;
+    for (; sealed + POSTING_BLOCK_SIZE <= postings_.size(); sealed += POSTING_BLOCK_SIZE) {
+        const int previous_document_id = blocks_.empty() ? -1 : blocks_.back().last_document_id;
+        blocks_.push_back(EncodePostingBlock(postings_.data() + sealed, previous_document_id, block_data_));
+    }
+    postings_.erase(postings_.begin(), postings_.begin() + sealed);
+}
+
+const Posting* PostingList::GetTail() const noexcept {
+    return IsView() ? view_ : postings_.data();
+}
+
+size_t PostingList::GetTailSize() const noexcept {
+    return IsView() ? view_size_ : postings_.size();
+}
+
+PostingCursor::PostingCursor(const PostingList& postings, int first_document_id, int last_document_id)
+    : postings_(&postings)
+    , last_document_id_(last_document_id) {
+    const std::vector<PostingBlock>& blocks = postings.blocks_;
+    if (!blocks.empty()) {
+        block_buffer_ = std::make_unique<Posting[]>(POSTING_BLOCK_SIZE);
+    }
+    while (next_block_ < blocks.size() && blocks[next_block_].last_document_id < first_document_id) {
+        ++next_block_;
+    }
+    LoadNextRun();
+    Seek(first_document_id);
+}
+
+void PostingCursor::Seek(int document_id) {
+    if (IsEnd() || current_->document_id >= document_id) {
+        return;
+    }
+    // блоки, целиком лежащие левее document_id, пропускаем по их последним id без распаковки
+    const std::vector<PostingBlock>& blocks = postings_->blocks_;
+    while ((run_end_ - 1)->document_id < document_id) {
+        while (next_block_ < blocks.size() && blocks[next_block_].last_document_id < document_id) {
+            ++next_block_;
+        }
+        LoadNextRun();
+        if (IsEnd()) {
+            return;
+        }
+    }
+    current_ = SeekPosting(current_, run_end_, document_id);
+    if (current_->document_id > last_document_id_) {
+        current_ = nullptr;
+    }
+}
+
+void PostingCursor::LoadNextRun() {
+    const std::vector<PostingBlock>& blocks = postings_->blocks_;
+    if (next_block_ < blocks.size()) {
+        const int previous_document_id = next_block_ == 0 ? -1 : blocks[next_block_ - 1].last_document_id;
+        DecodePostingBlock(blocks[next_block_], previous_document_id, postings_->block_data_.data(), block_buffer_.get());
+        ++next_block_;
+        current_ = block_buffer_.get();
+        run_end_ = current_ + POSTING_BLOCK_SIZE;
+    }
+    else if (!tail_loaded_ && postings_->GetTailSize() > 0) {
+        tail_loaded_ = true;
+        current_ = postings_->GetTail();
+        run_end_ = current_ + postings_->GetTailSize();
+    }
+    else {
+        current_ = nullptr;
+        return;
+    }
+    if (current_->document_id > last_document_id_) {
+        current_ = nullptr;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "posting_codec.h"
+
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct Posting {
+    int document_id;
+    double term_freq;
+};
+
+enum class PostingFormat {
+    PLAIN,
+    // блоки по POSTING_BLOCK_SIZE постингов с упакованными разностями id и tf во float;
+    // неполный хвост хранится несжатым, поэтому добавление документов по возрастанию id дешёвое
+    COMPRESSED,
+};
+
+// Постинг-лист терма: постинги (document_id, tf), отсортированные по document_id.
+// Список может не владеть памятью (постинги читаются прямо из отображённого снимка индекса);
+// тогда при первом изменении постинги копируются в собственный буфер.
+// Читается список только через PostingCursor.
+class PostingList {
+public:
+    explicit PostingList(PostingFormat format = PostingFormat::PLAIN);
+
+    // список поверх чужой памяти; она должна жить дольше списка
+    [[nodiscard]] static PostingList View(const Posting* postings, size_t size, double max_term_freq);
+
+    void Insert(int document_id, double term_freq);
+
+    // new_postings отсортированы по id, и таких id в списке ещё нет
+    void Merge(const std::vector<Posting>& new_postings);
+
+    bool Erase(int document_id);
+
+    [[nodiscard]] bool Contains(int document_id) const;
+
+    void SetFormat(PostingFormat format);
+    [[nodiscard]] PostingFormat GetFormat() const noexcept;
+
+    // верхняя граница tf по списку; при удалении не уменьшается, но остаётся корректной оценкой
+    [[nodiscard]] double GetMaxTermFreq() const noexcept;
+
+    [[nodiscard]] bool IsView() const noexcept;
+
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    friend class PostingCursor;
+
+    // переводит список в собственный несжатый буфер перед изменением
+    std::vector<Posting>& GetOwnPostings();
+
+    // упаковывает полные блоки из несжатого хвоста
+    void SealBlocks();
+
+    [[nodiscard]] const Posting* GetTail() const noexcept;
+    [[nodiscard]] size_t GetTailSize() const noexcept;
+
+    std::vector<Posting> postings_;
+    const Posting* view_ = nullptr;
+    size_t view_size_ = 0;
+    std::vector<PostingBlock> blocks_;
+    std::vector<uint32_t> block_data_;
+    PostingFormat format_ = PostingFormat::PLAIN;
+    double max_term_freq_ = 0.0;
+};
+
+// Последовательный обход постингов с id из [first_document_id, last_document_id].
+// Сжатые блоки распаковываются по одному во внутренний буфер; блоки целиком левее цели Seek
+// пропускаются без распаковки. Список не должен изменяться, пока курсор жив.
+class PostingCursor {
+public:
+    explicit PostingCursor(const PostingList& postings, int first_document_id = INT_MIN, int last_document_id = INT_MAX);
+
+    [[nodiscard]] bool IsEnd() const noexcept {
+        return current_ == nullptr;
+    }
+
+    [[nodiscard]] const Posting& operator*() const noexcept {
+        return *current_;
+    }
+
+    [[nodiscard]] const Posting* operator->() const noexcept {
+        return current_;
+    }
+
+    void Next() {
+        ++current_;
+        if (current_ == run_end_) {
+            LoadNextRun();
+        }
+        else if (current_->document_id > last_document_id_) {
+            current_ = nullptr;
+        }
+    }
+
+    // переходит к первому постингу с id >= document_id
+    void Seek(int document_id);
+
+private:
+    void LoadNextRun();
+
+    const PostingList* postings_;
+    std::unique_ptr<Posting[]> block_buffer_;
+    size_t next_block_ = 0;
+    bool tail_loaded_ = false;
+    const Posting* current_ = nullptr;
+    const Posting* run_end_ = nullptr;
+    int last_document_id_;
+};
@@ -1,30 +1,49 @@
-#include "process_queries.h"
-#include <algorithm>
-
-using namespace std;
-
-vector<vector<Document>> ProcessQueries(
-    const SearchServer& search_server,
-    const vector<string>& queries) 
-{
-    vector<vector<Document>> result(queries.size());
-    transform(execution::par, queries.begin(), queries.end(), result.begin(),
-        [&search_server](auto querie) {return search_server.FindTopDocuments(querie); });
-    return result;
-}
-
-list<Document> ProcessQueriesJoined(const SearchServer& search_server,
-    const vector<string>& queries)
-{
-    return transform_reduce(execution::par,
-        queries.begin(),
-        queries.end(),
-        list<Document>{},
-        [](list<Document> ins_to, list<Document> ins_from) {
-        ins_to.splice(ins_to.end(), move(ins_from));
-        return ins_to; },
-        [&search_server]( string_view raw_query) {
-            vector<Document> vector_tmp = move(search_server.FindTopDocuments(raw_query));
-            return list<Document>{ vector_tmp.begin(), vector_tmp.end() };
-        });
-}
\ No newline at end of file
+#include "process_queries.h"
+#include "query_batch.h"
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+
+namespace {
+    // запросы обрабатываются частями: общие слова части ищутся в словаре один раз
+    vector<DocumentBatch> ProcessQueryBatches(const SearchServer& search_server, const vector<string>& queries) {
+        const size_t part_size = ComputeBatchPartSize(queries.size(), thread::hardware_concurrency());
+        vector<DocumentBatch> batches((queries.size() + part_size - 1) / part_size);
+        vector<size_t> batch_indexes(batches.size());
+        iota(batch_indexes.begin(), batch_indexes.end(), 0);
+        for_each(execution::par, batch_indexes.begin(), batch_indexes.end(), [&search_server, &queries, &batches, part_size](size_t batch_index) {
+            const size_t first = batch_index * part_size;
+            const size_t last = min(first + part_size, queries.size());
+            const vector<string_view> raw_queries(queries.begin() + first, queries.begin() + last);
+            search_server.FindTopDocumentsBatch(raw_queries, batches[batch_index]);
+        });
+        return batches;
+    }
+}
+
+vector<vector<Document>> ProcessQueries(
+    const SearchServer& search_server,
+    const vector<string>& queries) 
+{
+    vector<vector<Document>> result;
+    result.reserve(queries.size());
+    for (const DocumentBatch& batch : ProcessQueryBatches(search_server, queries)) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            result.emplace_back(batch[i].begin(), batch[i].end());
+        }
+    }
+    return result;
+}
+
+list<Document> ProcessQueriesJoined(const SearchServer& search_server,
+    const vector<string>& queries)
+{
+    list<Document> result;
+    for (const DocumentBatch& batch : ProcessQueryBatches(search_server, queries)) {
+        result.insert(result.end(), batch.documents.begin(), batch.documents.end());
+    }
+    return result;
+}
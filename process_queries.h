@@ -1,10 +1,10 @@
-#pragma once
-#include "search_server.h"
-#include <list>
-
-std::vector<std::vector<Document>> ProcessQueries(
-    const SearchServer& search_server,
-    const std::vector<std::string>& queries);
-
-std::list<Document> ProcessQueriesJoined(const SearchServer& search_server,
+#pragma once
+#include "search_server.h"
+#include <list>
+
+std::vector<std::vector<Document>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+std::list<Document> ProcessQueriesJoined(const SearchServer& search_server,
     const std::vector<std::string>& queries);
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "query_batch.h"
+
+#include <algorithm>
+
+size_t ComputeBatchPartSize(size_t query_count, size_t thread_count) noexcept {
+    // несколько частей на поток выравнивают нагрузку, когда запросы разной тяжести
+    constexpr size_t PARTS_PER_THREAD = 4;
+    const size_t part_count = std::max<size_t>(thread_count, 1) * PARTS_PER_THREAD;
+    return std::clamp<size_t>((query_count + part_count - 1) / part_count, 1, MAX_BATCH_PART_SIZE);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Пакет запросов делится на части, которые выполняются параллельно (FindTopDocumentsBatch на часть).
+// Общие слова части ищутся в словаре один раз, поэтому части крупные, но не больше MAX_BATCH_PART_SIZE
+// запросов, и на каждый из thread_count потоков приходится несколько частей: малые пакеты и пакеты
+// тяжёлых запросов не выполняются одним потоком
+const size_t MAX_BATCH_PART_SIZE = 64;
+[[nodiscard]] size_t ComputeBatchPartSize(size_t query_count, size_t thread_count) noexcept;
@@ -0,0 +1,88 @@
+#include "query_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string_view>
+
+namespace {
+    struct BatchState {
+        std::vector<std::string> raw_queries;
+        size_t part_size = 0;
+        std::vector<DocumentBatch> parts;
+        std::vector<std::exception_ptr> errors;
+        std::atomic<size_t> remaining_parts = 0;
+        std::promise<DocumentBatch> result;
+    };
+
+    // последняя завершившаяся часть собирает результаты пакета
+    void CompleteBatch(BatchState& state) {
+        for (const std::exception_ptr& error : state.errors) {
+            if (error) {
+                state.result.set_exception(error);
+                return;
+            }
+        }
+        DocumentBatch batch;
+        batch.offsets.reserve(state.raw_queries.size() + 1);
+        size_t document_count = 0;
+        for (const DocumentBatch& part : state.parts) {
+            document_count += part.documents.size();
+        }
+        batch.documents.reserve(document_count);
+        for (const DocumentBatch& part : state.parts) {
+            for (size_t i = 0; i < part.size(); ++i) {
+                batch.Append(part[i].begin(), part[i].end());
+            }
+        }
+        state.result.set_value(std::move(batch));
+    }
+}
+
+QueryExecutor::QueryExecutor(const SearchServer& search_server, size_t thread_count, size_t queue_capacity)
+    : search_server_(search_server), pool_(thread_count, queue_capacity)
+{
+}
+
+std::future<std::vector<Document>> QueryExecutor::Submit(std::string raw_query) {
+    std::packaged_task<std::vector<Document>()> task([this, raw_query = std::move(raw_query)] {
+        return search_server_.FindTopDocuments(raw_query);
+    });
+    auto result = task.get_future();
+    pool_.Submit(ThreadPool::Task([task = std::move(task)]() mutable { task(); }));
+    return result;
+}
+
+std::future<DocumentBatch> QueryExecutor::SubmitBatch(std::vector<std::string> raw_queries) {
+    auto state = std::make_shared<BatchState>();
+    auto result = state->result.get_future();
+    state->part_size = ComputeBatchPartSize(raw_queries.size(), pool_.GetThreadCount());
+    const size_t part_count = (raw_queries.size() + state->part_size - 1) / state->part_size;
+    state->raw_queries = std::move(raw_queries);
+    if (part_count == 0) {
+        state->result.set_value(DocumentBatch{});
+        return result;
+    }
+    state->parts.resize(part_count);
+    state->errors.resize(part_count);
+    state->remaining_parts = part_count;
+
+    for (size_t part = 0; part < part_count; ++part) {
+        pool_.Submit(ThreadPool::Task([this, state, part] {
+            try {
+                const size_t first = part * state->part_size;
+                const size_t last = std::min(first + state->part_size, state->raw_queries.size());
+                const std::vector<std::string_view> raw_queries(state->raw_queries.begin() + first, state->raw_queries.begin() + last);
+                search_server_.FindTopDocumentsBatch(raw_queries, state->parts[part]);
+            }
+            catch (...) {
+                state->errors[part] = std::current_exception();
+            }
+            if (state->remaining_parts.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                CompleteBatch(*state);
+            }
+        }));
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "document.h"
+#include "query_batch.h"
+#include "search_server.h"
+#include "thread_pool.h"
+
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Исполнитель запросов к неизменяемому во время работы SearchServer (документы ACTUAL).
+// Потоки живут всё время жизни исполнителя; при заполненной очереди Submit ждёт.
+// Пакет делится на части (см. ComputeBatchPartSize) по потокам исполнителя: части выполняются
+// параллельно, а в пределах части общие слова запросов ищутся в словаре один раз.
+class QueryExecutor {
+public:
+    explicit QueryExecutor(const SearchServer& search_server,
+        size_t thread_count = std::thread::hardware_concurrency(), size_t queue_capacity = 1024);
+
+    [[nodiscard]] std::future<std::vector<Document>> Submit(std::string raw_query);
+
+    // результаты в порядке запросов; ошибка в любом запросе делает ошибочным весь пакет
+    [[nodiscard]] std::future<DocumentBatch> SubmitBatch(std::vector<std::string> raw_queries);
+
+private:
+    const SearchServer& search_server_;
+    ThreadPool pool_;
+};
@@ -0,0 +1,82 @@
+#include "query_result_cache.h"
+
+#include <functional>
+#include <iterator>
+
+QueryResultCache::QueryResultCache(size_t capacity_bytes)
+    : capacity_bytes_(capacity_bytes)
+{
+}
+
+std::optional<std::vector<Document>> QueryResultCache::Find(std::string_view key, uint64_t generation) {
+    Shard& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    const auto iter = shard.index.find(key);
+    if (iter == shard.index.end()) {
+        return std::nullopt;
+    }
+    if (iter->second->generation != generation) {
+        Erase(shard, iter->second);
+        return std::nullopt;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+    return iter->second->documents;
+}
+
+void QueryResultCache::Insert(std::string key, uint64_t generation, const std::vector<Document>& documents) {
+    Shard& shard = GetShard(key);
+    const size_t shard_capacity = capacity_bytes_ / SHARD_COUNT;
+    std::lock_guard lock(shard.mutex);
+    if (const auto iter = shard.index.find(key); iter != shard.index.end()) {
+        Erase(shard, iter->second);
+    }
+    shard.entries.push_front({ std::move(key), generation, documents });
+    const size_t entry_size = GetEntrySize(shard.entries.front());
+    if (entry_size > shard_capacity) {
+        shard.entries.pop_front();
+        return;
+    }
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+    shard.memory_usage += entry_size;
+    while (shard.memory_usage > shard_capacity) {
+        Erase(shard, std::prev(shard.entries.end()));
+    }
+}
+
+size_t QueryResultCache::GetCapacity() const noexcept {
+    return capacity_bytes_;
+}
+
+size_t QueryResultCache::GetMemoryUsage() const {
+    size_t memory_usage = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        memory_usage += shard.memory_usage;
+    }
+    return memory_usage;
+}
+
+size_t QueryResultCache::size() const {
+    size_t entry_count = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        entry_count += shard.entries.size();
+    }
+    return entry_count;
+}
+
+size_t QueryResultCache::GetEntrySize(const Entry& entry) noexcept {
+    // узлы списка и индекса примерно по четыре указателя сверх хранимого
+    return sizeof(Entry) + sizeof(std::string_view) + 8 * sizeof(void*)
+        + entry.key.capacity() + entry.documents.capacity() * sizeof(Document);
+}
+
+QueryResultCache::Shard& QueryResultCache::GetShard(std::string_view key) {
+    return shards_[std::hash<std::string_view>{}(key) % SHARD_COUNT];
+}
+
+void QueryResultCache::Erase(Shard& shard, std::list<Entry>::iterator entry) {
+    shard.memory_usage -= GetEntrySize(*entry);
+    shard.index.erase(entry->key);
+    shard.entries.erase(entry);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "document.h"
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Кэш результатов запросов, ограниченный по памяти, с вытеснением давно не использованных (LRU).
+// Ключи разложены по независимым частям со своими мьютексами, поэтому параллельные запросы
+// редко ждут друг друга. Каждый результат помнит поколение индекса, на котором он вычислен:
+// результат другого поколения считается устаревшим и удаляется при обращении.
+class QueryResultCache {
+public:
+    explicit QueryResultCache(size_t capacity_bytes);
+
+    [[nodiscard]] std::optional<std::vector<Document>> Find(std::string_view key, uint64_t generation);
+    void Insert(std::string key, uint64_t generation, const std::vector<Document>& documents);
+
+    [[nodiscard]] size_t GetCapacity() const noexcept;
+    [[nodiscard]] size_t GetMemoryUsage() const;
+    [[nodiscard]] size_t size() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Entry {
+        std::string key;
+        uint64_t generation;
+        std::vector<Document> documents;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        // в начале недавно использованные
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        size_t memory_usage = 0;
+    };
+
+    [[nodiscard]] static size_t GetEntrySize(const Entry& entry) noexcept;
+    [[nodiscard]] Shard& GetShard(std::string_view key);
+    static void Erase(Shard& shard, std::list<Entry>::iterator entry);
+
+    const size_t capacity_bytes_;
+    std::array<Shard, SHARD_COUNT> shards_;
+};
@@ -1,7 +1,7 @@
-#pragma once
-
-#include <string>
-
-[[nodiscard]] std::string ReadLine();
-
+#pragma once
+
+#include <string>
+
+[[nodiscard]] std::string ReadLine();
+
 [[nodiscard]] int ReadLineWithNumber();
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "relevance_accumulator.h"
+
+#include <algorithm>
+
+namespace {
+    thread_local bool flat_slots_in_use = false;
+}
+
+RelevanceAccumulator::RelevanceAccumulator(int first_document_id, int last_document_id, size_t expected_document_count)
+    : first_document_id_(first_document_id)
+{
+    const int64_t slot_count = static_cast<int64_t>(last_document_id) - first_document_id + 1;
+    const bool is_dense = static_cast<uint64_t>(slot_count) <= static_cast<uint64_t>(expected_document_count) * FLAT_SLOTS_PER_DOCUMENT;
+    if (slot_count > 0 && slot_count <= MAX_FLAT_SLOTS && is_dense) {
+        flat_slots_ = AcquireFlatSlots(static_cast<size_t>(slot_count));
+    }
+}
+
+RelevanceAccumulator::~RelevanceAccumulator() {
+    if (flat_slots_ != nullptr) {
+        for (const int document_id : touched_) {
+            (*flat_slots_)[document_id - first_document_id_] = Slot{};
+        }
+        ReleaseFlatSlots();
+    }
+}
+
+void RelevanceAccumulator::Exclude(int document_id) {
+    Slot& slot = GetSlot(document_id);
+    if (slot.state == SlotState::EMPTY) {
+        touched_.push_back(document_id);
+    }
+    slot.state = SlotState::REJECTED;
+}
+
+std::vector<std::pair<int, double>> RelevanceAccumulator::Collect() {
+    if (!std::is_sorted(touched_.begin(), touched_.end())) {
+        std::sort(touched_.begin(), touched_.end());
+    }
+    std::vector<std::pair<int, double>> result;
+    result.reserve(touched_.size());
+    for (const int document_id : touched_) {
+        const Slot& slot = GetSlot(document_id);
+        if (slot.state == SlotState::ACCEPTED) {
+            result.emplace_back(document_id, slot.relevance);
+        }
+    }
+    return result;
+}
+
+bool RelevanceAccumulator::IsFlat() const noexcept {
+    return flat_slots_ != nullptr;
+}
+
+std::vector<RelevanceAccumulator::Slot>* RelevanceAccumulator::AcquireFlatSlots(size_t slot_count) {
+    thread_local std::vector<Slot> flat_slots;
+    // поток может взять вторую задачу, пока ждёт первую (work stealing) - тогда уходим в хеш-таблицу
+    if (flat_slots_in_use) {
+        return nullptr;
+    }
+    flat_slots_in_use = true;
+    if (flat_slots.size() < slot_count) {
+        flat_slots.resize(slot_count);
+    }
+    return &flat_slots;
+}
+
+void RelevanceAccumulator::ReleaseFlatSlots() {
+    flat_slots_in_use = false;
+}
+
+RelevanceAccumulator::Slot& RelevanceAccumulator::GetSlot(int document_id) {
+    if (flat_slots_ != nullptr) {
+        return (*flat_slots_)[document_id - first_document_id_];
+    }
+    return hashed_slots_[document_id];
+}
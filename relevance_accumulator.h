@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Накопитель релевантности для диапазона id документов [first_document_id, last_document_id].
+// Если диапазон достаточно плотный - не шире MAX_FLAT_SLOTS и не больше чем в FLAT_SLOTS_PER_DOCUMENT
+// раз шире числа документов, которых коснётся запрос, - очки копятся в плоском массиве потока
+// (sparse set), иначе - в хеш-таблице. Накопители разных диапазонов не пересекаются,
+// поэтому параллельный поиск обходится без блокировок и без слияния map.
+class RelevanceAccumulator {
+public:
+    // expected_document_count - оценка сверху числа документов, которые будут добавлены или исключены
+    RelevanceAccumulator(int first_document_id, int last_document_id, size_t expected_document_count);
+    RelevanceAccumulator(const RelevanceAccumulator&) = delete;
+    RelevanceAccumulator& operator=(const RelevanceAccumulator&) = delete;
+    ~RelevanceAccumulator();
+
+    void Exclude(int document_id);
+
+    // document_filter вызывается один раз на документ, при первом касании
+    template <typename DocumentFilter>
+    void Add(int document_id, double relevance, DocumentFilter document_filter);
+
+    // принятые документы по возрастанию id
+    [[nodiscard]] std::vector<std::pair<int, double>> Collect();
+
+    // очки копятся в плоском массиве потока
+    [[nodiscard]] bool IsFlat() const noexcept;
+
+private:
+    enum class SlotState : uint8_t {
+        EMPTY,
+        ACCEPTED,
+        REJECTED,
+    };
+
+    struct Slot {
+        double relevance = 0.0;
+        SlotState state = SlotState::EMPTY;
+    };
+
+    // буфер потока не освобождается до конца потока, поэтому он не больше 16 МБ
+    static constexpr int64_t MAX_FLAT_SLOTS = 1 << 20;
+    // слот массива втрое меньше узла хеш-таблицы и не требует хеширования, поэтому массив выгоден
+    // и при заметной разреженности, но не тогда, когда на миллионы слотов приходятся единицы документов
+    static constexpr int64_t FLAT_SLOTS_PER_DOCUMENT = 64;
+
+    // плоский буфер потока; nullptr, если поток уже занят другим накопителем
+    [[nodiscard]] static std::vector<Slot>* AcquireFlatSlots(size_t slot_count);
+    static void ReleaseFlatSlots();
+
+    [[nodiscard]] Slot& GetSlot(int document_id);
+
+    int first_document_id_;
+    std::vector<Slot>* flat_slots_ = nullptr;
+    std::vector<int> touched_;
+    std::unordered_map<int, Slot> hashed_slots_;
+};
+
+template <typename DocumentFilter>
+void RelevanceAccumulator::Add(int document_id, double relevance, DocumentFilter document_filter) {
+    Slot& slot = GetSlot(document_id);
+    if (slot.state == SlotState::EMPTY) {
+        touched_.push_back(document_id);
+        slot.state = document_filter(document_id) ? SlotState::ACCEPTED : SlotState::REJECTED;
+    }
+    if (slot.state == SlotState::ACCEPTED) {
+        slot.relevance += relevance;
+    }
+}
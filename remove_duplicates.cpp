@@ -1,33 +1,207 @@
-#include "remove_duplicates.h"
-#include <set>
-#include <vector>
-#include <iterator>
-
-void RemoveDuplicates(SearchServer& search_server) {
-	std::map<std::set<std::string_view>, int> unic_documents;
-	std::vector<int> delete_id;
-
-	for (int id : search_server) {
-		std::set<std::string_view> document_checked_uniqueness;
-
-		auto str_v_freq = search_server.GetWordFrequencies(id);
-
-		std::transform(str_v_freq.begin(), str_v_freq.end(), std::inserter(document_checked_uniqueness, document_checked_uniqueness.begin()), [](std::pair<const std::string_view, double>& T1) { return T1.first; });
-
-		if (auto [iter, emplace_done] = unic_documents.emplace(document_checked_uniqueness, id); !emplace_done) {
-			if (iter->second > id) {
-				delete_id.push_back(iter->second);
-				unic_documents.erase(iter);
-				unic_documents[document_checked_uniqueness] = id;
-			}
-			else {
-				delete_id.push_back(id);
-			}
-		}
-	}
-
-	for (int i : delete_id) {
-		std::cout << "Found duplicate document id " << i << std::endl;
-		search_server.RemoveDocument(i);
-	}
-}
\ No newline at end of file
+#include "remove_duplicates.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+	constexpr size_t MINHASH_SIZE = 128;
+
+	uint64_t MixHash(uint64_t hash) noexcept {
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	uint64_t HashWord(std::string_view word) noexcept {
+		return MixHash(std::hash<std::string_view>{}(word));
+	}
+
+	// слова в карте упорядочены, поэтому отпечаток зависит только от набора слов
+	uint64_t ComputeFingerprint(const std::map<std::string_view, double>& word_freqs) noexcept {
+		uint64_t fingerprint = word_freqs.size();
+		for (const auto& [word, term_freq] : word_freqs) {
+			fingerprint = MixHash(fingerprint ^ HashWord(word)) + 0x9e3779b97f4a7c15ULL;
+		}
+		return fingerprint;
+	}
+
+	bool HaveSameWords(const std::map<std::string_view, double>& lhs, const std::map<std::string_view, double>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto& lhs_word, const auto& rhs_word) {
+			return lhs_word.first == rhs_word.first;
+		});
+	}
+
+	double ComputeJaccardSimilarity(const std::map<std::string_view, double>& lhs, const std::map<std::string_view, double>& rhs) {
+		if (lhs.empty() && rhs.empty()) {
+			return 1.0;
+		}
+		size_t common_count = 0;
+		for (auto lhs_it = lhs.begin(), rhs_it = rhs.begin(); lhs_it != lhs.end() && rhs_it != rhs.end();) {
+			if (lhs_it->first < rhs_it->first) {
+				++lhs_it;
+			}
+			else if (rhs_it->first < lhs_it->first) {
+				++rhs_it;
+			}
+			else {
+				++common_count;
+				++lhs_it;
+				++rhs_it;
+			}
+		}
+		return static_cast<double>(common_count) / static_cast<double>(lhs.size() + rhs.size() - common_count);
+	}
+
+	// i-я компонента сигнатуры - минимум i-й хеш-функции по словам документа
+	std::array<uint64_t, MINHASH_SIZE> ComputeMinHash(const std::map<std::string_view, double>& word_freqs) noexcept {
+		std::array<uint64_t, MINHASH_SIZE> signature;
+		signature.fill(UINT64_MAX);
+		for (const auto& [word, term_freq] : word_freqs) {
+			const uint64_t word_hash = HashWord(word);
+			for (size_t i = 0; i < MINHASH_SIZE; ++i) {
+				signature[i] = std::min(signature[i], MixHash(word_hash + (i + 1) * 0x9e3779b97f4a7c15ULL));
+			}
+		}
+		return signature;
+	}
+
+	// Полоса - row_count подряд идущих компонент сигнатуры; документы с равной полосой становятся
+	// кандидатами. Вероятность этого для сходства s равна 1 - (1 - s^r)^b, перелом кривой около
+	// (1/b)^(1/r); берётся самая длинная полоса, у которой перелом не выше порога.
+	size_t ChooseBandRowCount(double similarity_threshold) {
+		size_t row_count = 1;
+		for (size_t rows = 2; rows <= MINHASH_SIZE; ++rows) {
+			const double band_count = static_cast<double>(MINHASH_SIZE / rows);
+			if (std::pow(1.0 / band_count, 1.0 / static_cast<double>(rows)) <= similarity_threshold) {
+				row_count = rows;
+			}
+		}
+		return row_count;
+	}
+
+	int FindRoot(std::vector<int>& parents, int index) {
+		while (parents[index] != index) {
+			parents[index] = parents[parents[index]];
+			index = parents[index];
+		}
+		return index;
+	}
+}
+
+std::vector<int> FindDuplicates(const SearchServer& search_server) {
+	const std::vector<int> document_ids(search_server.begin(), search_server.end());
+	std::vector<std::pair<uint64_t, int>> fingerprints(document_ids.size());
+	std::transform(std::execution::par, document_ids.begin(), document_ids.end(), fingerprints.begin(), [&search_server](int document_id) {
+		return std::pair{ ComputeFingerprint(search_server.GetWordFrequencies(document_id)), document_id };
+	});
+	std::sort(std::execution::par, fingerprints.begin(), fingerprints.end());
+
+	// в группе с одним отпечатком каждый документ сверяется с оставленными до него
+	std::vector<int> duplicate_ids;
+	std::vector<int> kept_ids;
+	for (size_t first = 0; first < fingerprints.size();) {
+		size_t last = first + 1;
+		while (last < fingerprints.size() && fingerprints[last].first == fingerprints[first].first) {
+			++last;
+		}
+		kept_ids.assign(1, fingerprints[first].second);
+		for (size_t i = first + 1; i < last; ++i) {
+			const int document_id = fingerprints[i].second;
+			const auto& word_freqs = search_server.GetWordFrequencies(document_id);
+			const bool is_duplicate = std::any_of(kept_ids.begin(), kept_ids.end(), [&search_server, &word_freqs](int kept_id) {
+				return HaveSameWords(search_server.GetWordFrequencies(kept_id), word_freqs);
+			});
+			if (is_duplicate) {
+				duplicate_ids.push_back(document_id);
+			}
+			else {
+				kept_ids.push_back(document_id);
+			}
+		}
+		first = last;
+	}
+	std::sort(duplicate_ids.begin(), duplicate_ids.end());
+	return duplicate_ids;
+}
+
+std::vector<int> FindNearDuplicates(const SearchServer& search_server, double similarity_threshold) {
+	if (!(similarity_threshold > 0.0 && similarity_threshold <= 1.0)) {
+		throw std::invalid_argument(std::string{ "similarity threshold must be in (0, 1]" });
+	}
+	const std::vector<int> document_ids(search_server.begin(), search_server.end());
+	std::vector<std::array<uint64_t, MINHASH_SIZE>> signatures(document_ids.size());
+	std::transform(std::execution::par, document_ids.begin(), document_ids.end(), signatures.begin(), [&search_server](int document_id) {
+		return ComputeMinHash(search_server.GetWordFrequencies(document_id));
+	});
+
+	// Полосы обрабатываются независимо. В корзине документ сверяется с предыдущими, пока не найдёт
+	// похожий: этого ребра достаточно, чтобы попасть в группу, а корзина из одинаковых документов
+	// проверяется за линейное время.
+	const size_t row_count = ChooseBandRowCount(similarity_threshold);
+	std::vector<size_t> bands(MINHASH_SIZE / row_count);
+	std::iota(bands.begin(), bands.end(), size_t{ 0 });
+	std::vector<std::vector<std::pair<int, int>>> band_edges(bands.size());
+	std::for_each(std::execution::par, bands.begin(), bands.end(), [&](size_t band) {
+		std::vector<std::pair<uint64_t, int>> buckets(document_ids.size());
+		for (size_t i = 0; i < document_ids.size(); ++i) {
+			uint64_t band_hash = band;
+			for (size_t row = band * row_count; row < (band + 1) * row_count; ++row) {
+				band_hash = MixHash(band_hash ^ signatures[i][row]);
+			}
+			buckets[i] = { band_hash, static_cast<int>(i) };
+		}
+		std::sort(buckets.begin(), buckets.end());
+		for (size_t first = 0; first < buckets.size();) {
+			size_t last = first + 1;
+			while (last < buckets.size() && buckets[last].first == buckets[first].first) {
+				++last;
+			}
+			for (size_t i = first + 1; i < last; ++i) {
+				const auto& word_freqs = search_server.GetWordFrequencies(document_ids[buckets[i].second]);
+				for (size_t j = first; j < i; ++j) {
+					const auto& other_word_freqs = search_server.GetWordFrequencies(document_ids[buckets[j].second]);
+					if (ComputeJaccardSimilarity(other_word_freqs, word_freqs) >= similarity_threshold) {
+						band_edges[band].emplace_back(buckets[j].second, buckets[i].second);
+						break;
+					}
+				}
+			}
+			first = last;
+		}
+	});
+
+	// корнем группы становится наименьший индекс, а индексы идут по возрастанию id
+	std::vector<int> parents(document_ids.size());
+	std::iota(parents.begin(), parents.end(), 0);
+	for (const auto& edges : band_edges) {
+		for (const auto& [lhs, rhs] : edges) {
+			const int lhs_root = FindRoot(parents, lhs);
+			const int rhs_root = FindRoot(parents, rhs);
+			parents[std::max(lhs_root, rhs_root)] = std::min(lhs_root, rhs_root);
+		}
+	}
+	std::vector<int> duplicate_ids;
+	for (size_t i = 0; i < document_ids.size(); ++i) {
+		if (FindRoot(parents, static_cast<int>(i)) != static_cast<int>(i)) {
+			duplicate_ids.push_back(document_ids[i]);
+		}
+	}
+	return duplicate_ids;
+}
+
+std::vector<int> RemoveDuplicates(SearchServer& search_server) {
+	std::vector<int> duplicate_ids = FindDuplicates(search_server);
+	search_server.RemoveDocuments(std::execution::par, duplicate_ids);
+	return duplicate_ids;
+}
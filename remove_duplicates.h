@@ -1,4 +1,18 @@
-#pragma once
-#include "search_server.h"
-
-void RemoveDuplicates(SearchServer& search_server);
\ No newline at end of file
+#pragma once
+#include "search_server.h"
+
+#include <vector>
+
+// Дубликаты - документы с одинаковым набором слов (частоты не учитываются); из каждой группы
+// остаётся документ с наименьшим id. Наборы сравниваются по 64-битным отпечаткам, совпадения отпечатков
+// перепроверяются. Возвращает id дубликатов по возрастанию.
+[[nodiscard]] std::vector<int> FindDuplicates(const SearchServer& search_server);
+
+// Почти-дубликаты: сходство Жаккара наборов слов не меньше similarity_threshold из (0, 1].
+// Кандидаты отбираются по MinHash-сигнатурам с разбиением на полосы (LSH) и проверяются точным
+// сходством; связанные сходством документы образуют группу, в которой остаётся наименьший id.
+// Пара с сходством чуть выше порога может не стать кандидатом - поиск вероятностный.
+[[nodiscard]] std::vector<int> FindNearDuplicates(const SearchServer& search_server, double similarity_threshold);
+
+// удаляет найденные FindDuplicates документы одним пакетом и возвращает их id
+std::vector<int> RemoveDuplicates(SearchServer& search_server);
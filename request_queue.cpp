@@ -1,17 +1,21 @@
-#include "request_queue.h"
-
-std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentStatus status) {
-    return AddFindRequest(raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-        return document_status == status;
-    });
-}
-
-std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query) {
-    return AddFindRequest(raw_query, DocumentStatus::ACTUAL);
-}
-
-int RequestQueue::GetNoResultRequests() const {
-    return count_if(requests_.begin(), requests_.end(), [](const auto& request_) {
-        return request_.is_non_empty == false;
-    });
-}
\ No newline at end of file
+#include "request_queue.h"
+
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentStatus status) {
+    const auto start_time = RequestStatistics::Clock::now();
+    std::vector<Document> result = obj_.FindTopDocuments(std::execution::seq, raw_query, status);
+    const auto end_time = RequestStatistics::Clock::now();
+    statistics_.Record(result.size(), end_time - start_time, end_time);
+    return result;
+}
+
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query) {
+    return AddFindRequest(raw_query, DocumentStatus::ACTUAL);
+}
+
+int RequestQueue::GetNoResultRequests() const {
+    return static_cast<int>(statistics_.GetNoResultCount());
+}
+
+const RequestStatistics& RequestQueue::GetStatistics() const noexcept {
+    return statistics_;
+}
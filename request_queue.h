@@ -1,51 +1,38 @@
-#pragma once
-
-#include "search_server.h"
-
-#include <string>
-#include <vector>
-#include <deque>
-
-class RequestQueue {
-public:
-    explicit RequestQueue(const SearchServer& search_server) : obj_(search_server) {
-    }
-    template <typename DocumentPredicate>
-    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate);
-    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentStatus status);
-    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query);
-
-    [[nodiscard]] int GetNoResultRequests() const;
-private:
-    struct QueryResult {
-        std::vector<Document> result;
-        bool is_non_empty;
-    };
-    std::deque<QueryResult> requests_;
-    const static int sec_in_day_ = 1440;
-    const SearchServer& obj_;
-};
-
-template <typename DocumentPredicate>
-std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate) {
-    std::vector<Document> result = obj_.FindTopDocuments(std::execution::seq ,raw_query, document_predicate);
-    if (!result.empty()) {
-        if (requests_.size() >= sec_in_day_) {
-            requests_.push_back(QueryResult{ result , true });
-            requests_.pop_front();
-        }
-        else {
-            requests_.push_back(QueryResult{ result , true });
-        }
-    }
-    else {
-        if (requests_.size() >= sec_in_day_) {
-            requests_.push_back(QueryResult{ result , false });
-            requests_.pop_front();
-        }
-        else {
-            requests_.push_back(QueryResult{ result , false });
-        }
-    }
-    return result;
-}
\ No newline at end of file
+#pragma once
+
+#include "search_server.h"
+#include "request_statistics.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Обёртка над поиском, которая собирает статистику запросов за последние сутки (или другое окно).
+// Результаты не копируются: в статистику попадают только число найденных документов и задержка.
+// Потокобезопасна, если сервер не изменяется во время поиска.
+class RequestQueue {
+public:
+    explicit RequestQueue(const SearchServer& search_server, RequestStatistics::Clock::duration window = std::chrono::hours(24))
+        : obj_(search_server), statistics_(window) {
+    }
+    template <typename DocumentPredicate>
+    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate);
+    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentStatus status);
+    [[nodiscard]] std::vector<Document> AddFindRequest(const std::string_view& raw_query);
+
+    // запросы без результатов в окне
+    [[nodiscard]] int GetNoResultRequests() const;
+    [[nodiscard]] const RequestStatistics& GetStatistics() const noexcept;
+private:
+    const SearchServer& obj_;
+    RequestStatistics statistics_;
+};
+
+template <typename DocumentPredicate>
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate) {
+    const auto start_time = RequestStatistics::Clock::now();
+    std::vector<Document> result = obj_.FindTopDocuments(std::execution::seq, raw_query, document_predicate);
+    const auto end_time = RequestStatistics::Clock::now();
+    statistics_.Record(result.size(), end_time - start_time, end_time);
+    return result;
+}
@@ -0,0 +1,160 @@
+#include "request_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    int FindHighestBit(uint64_t value) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    // полоса закрепляется за потоком, чтобы потоки не толкались на одних строках кэша
+    size_t GetThreadStripe(size_t stripe_count) noexcept {
+        thread_local const size_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return thread_hash % stripe_count;
+    }
+}
+
+RequestStatistics::RequestStatistics(Clock::duration window, size_t bucket_count)
+    : bucket_width_(bucket_count == 0 ? window : window / static_cast<Clock::rep>(bucket_count))
+    , bucket_count_(bucket_count)
+    , start_time_(Clock::now())
+    , slots_(STRIPE_COUNT * bucket_count) {
+    if (bucket_count == 0 || bucket_width_ <= Clock::duration::zero()) {
+        throw std::invalid_argument(std::string{ "statistics window must be split into non-empty intervals" });
+    }
+}
+
+void RequestStatistics::Record(size_t result_count, Clock::duration latency, Clock::time_point time) noexcept {
+    const int64_t interval = GetInterval(time);
+    Slot& slot = slots_[GetThreadStripe(STRIPE_COUNT) * bucket_count_ + static_cast<size_t>(interval) % bucket_count_];
+    for (int64_t current = slot.interval.load(std::memory_order_acquire); current != interval;
+        current = slot.interval.load(std::memory_order_acquire)) {
+        if (current == RESETTING_INTERVAL) {
+            // другой поток обнуляет ячейку: это несколько сотен записей
+            std::this_thread::yield();
+            continue;
+        }
+        if (current > interval) {
+            // запись опоздала на целое окно: её интервал уже вытеснен
+            return;
+        }
+        if (slot.interval.compare_exchange_weak(current, RESETTING_INTERVAL, std::memory_order_acquire)) {
+            slot.request_count.store(0, std::memory_order_relaxed);
+            slot.no_result_count.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t>& latency_count : slot.latency_counts) {
+                latency_count.store(0, std::memory_order_relaxed);
+            }
+            slot.interval.store(interval, std::memory_order_release);
+            break;
+        }
+    }
+    slot.request_count.fetch_add(1, std::memory_order_relaxed);
+    if (result_count == 0) {
+        slot.no_result_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.latency_counts[GetLatencyBin(latency)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t RequestStatistics::GetRequestCount(Clock::time_point now) const noexcept {
+    uint64_t request_count = 0;
+    ForEachSlotInWindow(now, [&request_count](const Slot& slot) {
+        request_count += slot.request_count.load(std::memory_order_relaxed);
+    });
+    return request_count;
+}
+
+uint64_t RequestStatistics::GetNoResultCount(Clock::time_point now) const noexcept {
+    uint64_t no_result_count = 0;
+    ForEachSlotInWindow(now, [&no_result_count](const Slot& slot) {
+        no_result_count += slot.no_result_count.load(std::memory_order_relaxed);
+    });
+    return no_result_count;
+}
+
+double RequestStatistics::GetNoResultRate(Clock::time_point now) const noexcept {
+    uint64_t request_count = 0;
+    uint64_t no_result_count = 0;
+    ForEachSlotInWindow(now, [&request_count, &no_result_count](const Slot& slot) {
+        request_count += slot.request_count.load(std::memory_order_relaxed);
+        no_result_count += slot.no_result_count.load(std::memory_order_relaxed);
+    });
+    return request_count == 0 ? 0.0 : static_cast<double>(no_result_count) / static_cast<double>(request_count);
+}
+
+double RequestStatistics::GetQueriesPerSecond(Clock::time_point now) const noexcept {
+    // окно - полные предыдущие интервалы и начатый текущий
+    const Clock::duration current_part = now.time_since_epoch() - GetInterval(now) * bucket_width_;
+    const Clock::duration span = std::min(bucket_width_ * static_cast<Clock::rep>(bucket_count_ - 1) + current_part, now - start_time_);
+    const double seconds = std::chrono::duration<double>(span).count();
+    return seconds <= 0.0 ? 0.0 : static_cast<double>(GetRequestCount(now)) / seconds;
+}
+
+std::chrono::microseconds RequestStatistics::GetLatencyPercentile(double percentile, Clock::time_point now) const noexcept {
+    std::array<uint64_t, LATENCY_BIN_COUNT> latency_counts{};
+    uint64_t request_count = 0;
+    ForEachSlotInWindow(now, [&latency_counts, &request_count](const Slot& slot) {
+        for (size_t bin = 0; bin < LATENCY_BIN_COUNT; ++bin) {
+            const uint64_t count = slot.latency_counts[bin].load(std::memory_order_relaxed);
+            latency_counts[bin] += count;
+            request_count += count;
+        }
+    });
+    if (request_count == 0) {
+        return std::chrono::microseconds::zero();
+    }
+    const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(request_count))));
+    uint64_t seen_count = 0;
+    for (size_t bin = 0; bin < LATENCY_BIN_COUNT; ++bin) {
+        seen_count += latency_counts[bin];
+        if (seen_count >= rank) {
+            return GetBinLatency(bin);
+        }
+    }
+    return GetBinLatency(LATENCY_BIN_COUNT - 1);
+}
+
+RequestStatistics::Clock::duration RequestStatistics::GetWindow() const noexcept {
+    return bucket_width_ * static_cast<Clock::rep>(bucket_count_);
+}
+
+int64_t RequestStatistics::GetInterval(Clock::time_point time) const noexcept {
+    return static_cast<int64_t>(time.time_since_epoch() / bucket_width_);
+}
+
+size_t RequestStatistics::GetLatencyBin(Clock::duration latency) noexcept {
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    if (microseconds < 4) {
+        return static_cast<size_t>(std::max<decltype(microseconds)>(microseconds, 0));
+    }
+    const uint64_t value = static_cast<uint64_t>(microseconds);
+    const int octave = FindHighestBit(value);
+    const size_t bin = static_cast<size_t>(octave - 1) * 4 + ((value >> (octave - 2)) & 3);
+    return std::min(bin, LATENCY_BIN_COUNT - 1);
+}
+
+std::chrono::microseconds RequestStatistics::GetBinLatency(size_t bin) noexcept {
+    if (bin < 4) {
+        return std::chrono::microseconds(bin);
+    }
+    // середина бина: [(4 + sub) << (octave - 2), (5 + sub) << (octave - 2))
+    const int octave = static_cast<int>(bin / 4) + 1;
+    const uint64_t lower = (4 + bin % 4) << (octave - 2);
+    const uint64_t width = uint64_t{ 1 } << (octave - 2);
+    return std::chrono::microseconds(static_cast<int64_t>(lower + width / 2));
+}
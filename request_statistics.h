@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Статистика запросов в скользящем окне времени. Окно делится на bucket_count интервалов,
+// каждый интервал хранит не записи запросов, а их сводку: число запросов, число пустых ответов
+// и гистограмму задержек. Ячейки интервалов образуют кольцо и переиспользуются по кругу.
+// Record не берёт блокировок: потоки пишут в свою полосу кольца атомарными инкрементами,
+// а кольцо полосы обнуляется одним потоком, выигравшим CAS при переходе к новому интервалу.
+// Чтение обходит фиксированное число ячеек и не зависит от числа запросов. Окно отсчитывается
+// с точностью до одного интервала, задержки - с относительной погрешностью до 13%.
+class RequestStatistics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestStatistics(Clock::duration window = std::chrono::hours(24), size_t bucket_count = 60);
+
+    void Record(size_t result_count, Clock::duration latency, Clock::time_point time = Clock::now()) noexcept;
+
+    [[nodiscard]] uint64_t GetRequestCount(Clock::time_point now = Clock::now()) const noexcept;
+    [[nodiscard]] uint64_t GetNoResultCount(Clock::time_point now = Clock::now()) const noexcept;
+    // доля запросов без результатов, 0 при пустом окне
+    [[nodiscard]] double GetNoResultRate(Clock::time_point now = Clock::now()) const noexcept;
+    // запросы в секунду за окно; пока окно не заполнено - за время с создания
+    [[nodiscard]] double GetQueriesPerSecond(Clock::time_point now = Clock::now()) const noexcept;
+    // задержка, которую не превысили percentile процентов запросов окна, percentile из [0, 100]
+    [[nodiscard]] std::chrono::microseconds GetLatencyPercentile(double percentile, Clock::time_point now = Clock::now()) const noexcept;
+
+    [[nodiscard]] Clock::duration GetWindow() const noexcept;
+
+private:
+    // бины 0..3 - точные значения в мкс, дальше по 4 бина на октаву
+    static constexpr size_t LATENCY_BIN_COUNT = 124;
+    static constexpr size_t STRIPE_COUNT = 8;
+    static constexpr int64_t EMPTY_INTERVAL = INT64_MIN;
+    static constexpr int64_t RESETTING_INTERVAL = INT64_MIN + 1;
+
+    struct alignas(64) Slot {
+        // номер интервала, чью сводку хранит ячейка
+        std::atomic<int64_t> interval{ EMPTY_INTERVAL };
+        std::atomic<uint64_t> request_count{ 0 };
+        std::atomic<uint64_t> no_result_count{ 0 };
+        std::array<std::atomic<uint64_t>, LATENCY_BIN_COUNT> latency_counts{};
+    };
+
+    [[nodiscard]] int64_t GetInterval(Clock::time_point time) const noexcept;
+    [[nodiscard]] static size_t GetLatencyBin(Clock::duration latency) noexcept;
+    [[nodiscard]] static std::chrono::microseconds GetBinLatency(size_t bin) noexcept;
+
+    // function(const Slot&) для ячеек интервалов, попадающих в окно, которое заканчивается в now
+    template <typename Function>
+    void ForEachSlotInWindow(Clock::time_point now, Function function) const noexcept;
+
+    Clock::duration bucket_width_;
+    size_t bucket_count_;
+    Clock::time_point start_time_;
+    // ячейка интервала i полосы s - slots_[s * bucket_count_ + i % bucket_count_]
+    std::vector<Slot> slots_;
+};
+
+template <typename Function>
+void RequestStatistics::ForEachSlotInWindow(Clock::time_point now, Function function) const noexcept {
+    const int64_t last_interval = GetInterval(now);
+    for (const Slot& slot : slots_) {
+        const int64_t interval = slot.interval.load(std::memory_order_acquire);
+        if (interval <= last_interval && interval > last_interval - static_cast<int64_t>(bucket_count_)) {
+            function(slot);
+        }
+    }
+}
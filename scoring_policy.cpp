@@ -0,0 +1,19 @@
+#include "scoring_policy.h"
+
+#include <stdexcept>
+#include <string>
+
+Bm25Scoring::Bm25Scoring(double k1, double b)
+    : k1_(k1), b_(b) {
+    if (!(k1 >= 0.0) || !(b >= 0.0 && b <= 1.0)) {
+        throw std::invalid_argument(std::string{ "BM25 parameters must satisfy k1 >= 0 and 0 <= b <= 1" });
+    }
+}
+
+double Bm25Scoring::GetK1() const noexcept {
+    return k1_;
+}
+
+double Bm25Scoring::GetB() const noexcept {
+    return b_;
+}
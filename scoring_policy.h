@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Функция ранжирования - тип-политика, который подставляется в шаблоны поиска SearchServer.
+// Вклад терма считается во внутреннем цикле по постингам, поэтому политика вызывается напрямую
+// и встраивается: ни виртуального вызова, ни проверки режима на каждый постинг. Политика должна иметь
+//   double TermWeight(const TermStatistics& term, const CollectionStatistics& collection) const -
+//       вес слова запроса, считается один раз на запрос;
+//   double Score(double term_freq, double term_weight) const или
+//   double Score(double term_freq, double term_weight, const DocumentLength& document) const -
+//       вклад терма в релевантность документа; term_freq - доля слова среди нестоп-слов документа.
+//       Длина документа читается из индекса, только если политика принимает её;
+// и может иметь
+//   double UpperBound(double max_term_freq, double term_weight, const CollectionStatistics& collection) const -
+//       границу Score сверху для документов с term_freq <= max_term_freq. С ней top-K отбирается
+//       с отсечением (MaxScore), без неё релевантность считается для всех документов запроса.
+
+struct CollectionStatistics {
+    size_t document_count = 0;
+    // среднее число нестоп-слов в документе
+    double average_document_length = 0.0;
+};
+
+struct TermStatistics {
+    // число документов с термом
+    size_t document_freq = 0;
+    // log(N / df), посчитанный сервером в его режиме IdfConsistency
+    double inverse_document_freq = 0.0;
+    // слово индекса; нужно политикам, которые берут статистику не у сервера (см. ShardedSearchServer)
+    std::string_view term;
+};
+
+struct DocumentLength {
+    uint32_t length = 0;
+    double average_length = 0.0;
+};
+
+// tf * idf - ранжирование по умолчанию
+struct TfIdfScoring {
+    [[nodiscard]] double TermWeight(const TermStatistics& term, const CollectionStatistics&) const noexcept {
+        return term.inverse_document_freq;
+    }
+
+    [[nodiscard]] double Score(double term_freq, double term_weight) const noexcept {
+        return term_freq * term_weight;
+    }
+
+    [[nodiscard]] double UpperBound(double max_term_freq, double term_weight, const CollectionStatistics&) const noexcept {
+        return max_term_freq * term_weight;
+    }
+};
+
+// Okapi BM25: вклад насыщается с числом вхождений и нормируется длиной документа
+class Bm25Scoring {
+public:
+    // k1 >= 0 - насыщение по числу вхождений, b из [0, 1] - сила нормировки по длине
+    explicit Bm25Scoring(double k1 = 1.2, double b = 0.75);
+
+    [[nodiscard]] double GetK1() const noexcept;
+    [[nodiscard]] double GetB() const noexcept;
+
+    // log(1 + (N - df + 0.5) / (df + 0.5)): в отличие от исходного log((N - df + 0.5) / (df + 0.5))
+    // не отрицателен и для слов, которые есть в большинстве документов
+    [[nodiscard]] double TermWeight(const TermStatistics& term, const CollectionStatistics& collection) const noexcept {
+        const double document_freq = static_cast<double>(term.document_freq);
+        return std::log(1.0 + (static_cast<double>(collection.document_count) - document_freq + 0.5) / (document_freq + 0.5));
+    }
+
+    [[nodiscard]] double Score(double term_freq, double term_weight, const DocumentLength& document) const noexcept {
+        const double length = static_cast<double>(document.length);
+        const double count = term_freq * length;
+        return term_weight * count * (k1_ + 1.0) / (count + k1_ * (1.0 - b_ + b_ * length / document.average_length));
+    }
+
+    // При доле вхождений t вклад w (k1 + 1) t / (t + k1 (1 - b) / L + k1 b / avgdl) растёт с длиной L
+    // и стремится к w (k1 + 1) t / (t + k1 b / avgdl)
+    [[nodiscard]] double UpperBound(double max_term_freq, double term_weight, const CollectionStatistics& collection) const noexcept {
+        if (b_ == 0.0 || collection.average_document_length == 0.0) {
+            return term_weight * (k1_ + 1.0);
+        }
+        return term_weight * (k1_ + 1.0) * max_term_freq / (max_term_freq + k1_ * b_ / collection.average_document_length);
+    }
+
+private:
+    double k1_;
+    double b_;
+};
+
+// Score политики принимает длину документа
+template <typename ScoringPolicy, typename = void>
+struct UsesDocumentLength : std::false_type {};
+template <typename ScoringPolicy>
+struct UsesDocumentLength<ScoringPolicy, std::void_t<decltype(std::declval<const ScoringPolicy&>().Score(0.0, 0.0, std::declval<const DocumentLength&>()))>>
+    : std::true_type {};
+
+// у политики есть UpperBound, и top-K можно отбирать с отсечением
+template <typename ScoringPolicy, typename = void>
+struct HasScoreUpperBound : std::false_type {};
+template <typename ScoringPolicy>
+struct HasScoreUpperBound<ScoringPolicy, std::void_t<decltype(std::declval<const ScoringPolicy&>().UpperBound(0.0, 0.0, std::declval<const CollectionStatistics&>()))>>
+    : std::true_type {};
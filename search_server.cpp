@@ -1,163 +1,1089 @@
-#include "search_server.h"
-
-#include <cmath>
-
-
-
-void SearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) {
-    if (document_id < 0) {
-        throw std::invalid_argument(std::string{ "id    >= 0!" });
-    }
-
-    if (documents_.count(document_id)) {
-        throw std::invalid_argument(std::string{ "   id  !" });
-    }
-    const auto words = SplitIntoWordsNoStop(document);
-
-    const double inv_word_count = 1.0 / words.size();
-    for (const std::string& word : words) {
-        word_to_document_freqs_[word][document_id] += inv_word_count;
-        document_to_word_freqs_[document_id][word_to_document_freqs_.find(word)->first] += inv_word_count;
-    }
-    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status });
-    document_ids_.insert(document_id);
-}
-
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const {
-    return FindTopDocuments(std::execution::seq, raw_query, status);
-}
-
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query) const {
-    return FindTopDocuments(std::execution::seq, raw_query, DocumentStatus::ACTUAL);
-}
-
-int SearchServer::GetDocumentCount() const noexcept {
-    return documents_.size();
-}
-
-std::set<int>::const_iterator SearchServer::begin() const noexcept {
-    return document_ids_.begin();
-}
-
-std::set<int>::const_iterator SearchServer::end() const noexcept {
-    return document_ids_.cend();
-}
-
-const std::map<std::string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
-    if (document_to_word_freqs_.find(document_id) != document_to_word_freqs_.end()) {
-        return document_to_word_freqs_.at(document_id);
-    }
-    static std::map<std::string_view, double> empty;
-    return  empty;
-}
-
-void SearchServer::RemoveDocument(int document_id) {
-    RemoveDocument(std::execution::seq, document_id);
-}
-
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument( std::string_view raw_query, int document_id) const {
-    return MatchDocument(std::execution::seq, raw_query, document_id);
-}
-
-bool SearchServer::IsContainWord(const std::string& word) const {
-    return word_to_document_freqs_.count(word);
-}
-
-bool SearchServer::IsWordContainId(const std::string& word, const int doc_id) const {
-    return word_to_document_freqs_.at(word).count(doc_id);
-}
-
-bool SearchServer::IsStopWord(const std::string& word) const {
-    return stop_words_.count(word) > 0;
-}
-
-bool SearchServer::CheckingForSpecialSymbols(const std::string_view& s) {
-    for (const char c : s) {
-        if (c >= 0 && c <= 31)
-            return true;
-    }
-    return false;
-}
-
-void SearchServer::ChekingRawQuery(const std::string_view& raw_query) const {
-    for (size_t i = 0; i + 1 < raw_query.size(); ++i) {
-        if (raw_query.at(i) == '-' && (raw_query.at(i + 1) == '-' || raw_query.at(i + 1) == ' ')) {
-            throw std::invalid_argument(std::string{ "invalid query" });
-        }
-    }
-    if (raw_query.at(raw_query.size() - 1) == '-') {
-        throw std::invalid_argument(std::string{ "invalid query empty minus word" });
-    }
-    if (CheckingForSpecialSymbols(raw_query)) {
-        throw std::invalid_argument(std::string{ "invalid query special symbols" });
-    }
-
-}
-
-
-std::vector<std::string> SearchServer::SplitIntoWordsNoStop(const std::string_view& text) const {
-    std::vector<std::string> words;
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        if (CheckingForSpecialSymbols(word)) {
-            throw std::invalid_argument(std::string{ "Word  is invalid" });
-        }
-        if (std::string s_word = static_cast<std::string>(word); !IsStopWord(s_word)) {
-
-            words.push_back(s_word);
-        }
-    }
-    return words;
-}
-
-int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
-    if (ratings.empty()) {
-        return 0;
-    }
-    int rating_sum = 0;
-    for (const int rating : ratings) {
-        rating_sum += rating;
-    }
-    return rating_sum / static_cast<int>(ratings.size());
-}
-
-SearchServer::QueryWord SearchServer::ParseQueryWord( std::string_view text) const {
-    if (text.empty()) {
-        throw std::invalid_argument(std::string{ "Query word is empty" });
-    }
-    bool is_minus = false;
-    if (text[0] == '-') {
-        is_minus = true;
-        text.remove_prefix(1);
-    }
-    if (text.empty() || text[0] == '-' || CheckingForSpecialSymbols(text)) {
-        throw std::invalid_argument(std::string{ "Query word is invalid" });
-    }
-
-    return { static_cast<std::string>(text), is_minus, IsStopWord(static_cast<std::string>(text)) };
-}
-
-SearchServer::Query SearchServer::ParseQuery( std::string_view text) const {
-    Query result;
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        const auto query_word = ParseQueryWord(word);
-        if (!query_word.is_stop) {
-            query_word.is_minus ? result.minus_words.insert(query_word.data) : result.plus_words.insert(query_word.data);
-        }
-    }
-    return result;
-}
-
-double SearchServer::ComputeWordInverseDocumentFreq(const std::string& word) const {
-    return log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(word).size());
-}
-
-void PrintMatchDocumentResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status) {
-    std::cout << std::string{ "{ " }
-        << std::string{ "document_id = " } << document_id << std::string{ ", " }
-        << std::string{ "status = " } << static_cast<int>(status) << std::string{ ", " }
-    << std::string{ "words =" };
-    for (const std::string_view& word : words) {
-        std::cout << ' ' << word;
-    }
-    std::cout << std::string{ "}" } << std::endl;
-}
+#include "search_server.h"
+
+#include <cmath>
+#include <cstddef>
+
+
+
+void SearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) {
+    PollMerge();
+    CheckNewDocumentId(document_id);
+    std::vector<std::vector<uint32_t>> word_positions;
+    uint32_t word_count = 0;
+    const auto document_word_freqs = ComputeWordFreqs(document, word_count, is_position_indexing_ ? &word_positions : nullptr);
+
+    std::vector<TermDictionary::TermId> term_ids;
+    term_ids.reserve(document_word_freqs.size());
+    for (const auto& [word, term_freq] : document_word_freqs) {
+        term_ids.push_back(terms_.Intern(word));
+    }
+    mutable_segment_.Resize(terms_.size());
+    document_freqs_.resize(terms_.size(), 0);
+    inverse_document_freqs_.Reserve(terms_.size());
+    const int document_number = documents_.Add(document_id, status, ComputeAverageRating(ratings), word_count);
+    auto& word_freqs = document_word_freqs_.emplace_back();
+    for (size_t i = 0; i < term_ids.size(); ++i) {
+        const TermDictionary::TermId term_id = term_ids[i];
+        const double term_freq = document_word_freqs[i].second;
+        mutable_segment_.GetPostings(term_id).Insert(document_number, term_freq);
+        inverse_document_freqs_.SetDocumentFreq(term_id, ++document_freqs_[term_id]);
+        word_freqs.emplace_hint(word_freqs.end(), terms_.GetTerm(term_id), term_freq);
+    }
+    if (is_position_indexing_) {
+        std::vector<std::pair<TermDictionary::TermId, std::vector<uint32_t>>> term_positions;
+        term_positions.reserve(term_ids.size());
+        for (size_t i = 0; i < term_ids.size(); ++i) {
+            term_positions.emplace_back(term_ids[i], std::move(word_positions[i]));
+        }
+        positions_.Add(document_number, PositionIndex::Encode(std::move(term_positions)));
+    }
+    inverse_document_freqs_.SetDocumentCount(GetDocumentCount());
+    ++generation_;
+    if (!term_ids.empty()) {
+        mutable_segment_.SetDocumentCount(mutable_segment_.GetDocumentCount() + 1);
+        if (mutable_segment_.GetDocumentCount() >= max_segment_document_count_) {
+            SealMutableSegment();
+        }
+    }
+}
+
+void SearchServer::AddDocuments(const std::vector<NewDocument>& documents) {
+    AddDocuments(std::execution::seq, documents);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const {
+    return FindTopDocuments(std::execution::seq, raw_query, status);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query) const {
+    return FindTopDocuments(std::execution::seq, raw_query, DocumentStatus::ACTUAL);
+}
+
+void SearchServer::FindTopDocumentsBatch(const std::vector<std::string_view>& raw_queries, DocumentBatch& result) const {
+    std::vector<Query> queries(raw_queries.size());
+    // запросы, найденные в кэше, не разрешаются
+    std::vector<std::string> cache_keys(result_cache_ ? raw_queries.size() : 0);
+    std::vector<std::optional<std::vector<Document>>> cached_documents(raw_queries.size());
+    std::vector<std::string_view> words;
+    for (size_t i = 0; i < raw_queries.size(); ++i) {
+        ParseQuery(raw_queries[i], queries[i]);
+        if (result_cache_) {
+            cache_keys[i] = MakeResultCacheKey(queries[i], DocumentStatus::ACTUAL, max_result_document_count_);
+            cached_documents[i] = result_cache_->Find(cache_keys[i], generation_);
+            if (cached_documents[i]) {
+                continue;
+            }
+        }
+        // запросы с фразами, близостью слов и нечёткими термами ищутся по отдельности
+        if (!queries[i].phrase_ends.empty() || IsProximityRanking(queries[i]) || !queries[i].fuzzy_terms.empty()) {
+            continue;
+        }
+        words.insert(words.end(), queries[i].plus_words.begin(), queries[i].plus_words.end());
+        words.insert(words.end(), queries[i].minus_words.begin(), queries[i].minus_words.end());
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    // слова пакета разрешаются один раз; IDF считается только для найденных термов
+    std::vector<std::pair<TermDictionary::TermId, double>> word_terms(words.size(), { TermDictionary::NO_TERM, 0.0 });
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (const TermDictionary::TermId term_id = FindIndexedTerm(words[i]); term_id != TermDictionary::NO_TERM) {
+            word_terms[i] = { term_id, ComputeWordInverseDocumentFreq(term_id) };
+        }
+    }
+    const auto find_term = [&words, &word_terms](std::string_view word) {
+        return word_terms[std::lower_bound(words.begin(), words.end(), word) - words.begin()];
+    };
+
+    const StatusFilter is_actual{ DocumentStatus::ACTUAL };
+    std::vector<std::pair<TermDictionary::TermId, double>> plus_terms;
+    std::vector<TermDictionary::TermId> minus_terms;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (cached_documents[i]) {
+            result.Append(cached_documents[i]->begin(), cached_documents[i]->end());
+            continue;
+        }
+        const Query& query = queries[i];
+        std::vector<Document> documents;
+        if (!query.phrase_ends.empty() || IsProximityRanking(query) || !query.fuzzy_terms.empty()) {
+            documents = FindTopDocumentsByQuery(std::execution::seq, query, is_actual, max_result_document_count_, TfIdfScoring{});
+        }
+        else {
+            plus_terms.clear();
+            minus_terms.clear();
+            for (const std::string_view word : query.plus_words) {
+                if (const auto term = find_term(word); term.first != TermDictionary::NO_TERM) {
+                    plus_terms.push_back(term);
+                }
+            }
+            for (const std::string_view word : query.minus_words) {
+                if (const auto term = find_term(word); term.first != TermDictionary::NO_TERM) {
+                    minus_terms.push_back(term.first);
+                }
+            }
+            documents = FindTopDocumentsByTerms(std::execution::seq, ResolveSegmentTerms(plus_terms, minus_terms), is_actual, max_result_document_count_, TfIdfScoring{});
+        }
+        result.Append(documents.begin(), documents.end());
+        if (result_cache_) {
+            result_cache_->Insert(std::move(cache_keys[i]), generation_, documents);
+        }
+    }
+}
+
+void SearchServer::SetIdfConsistency(IdfConsistency consistency) {
+    InverseDocumentFreqs inverse_document_freqs(consistency);
+    inverse_document_freqs.Reserve(document_freqs_.size());
+    for (TermDictionary::TermId term_id = 0; term_id < document_freqs_.size(); ++term_id) {
+        inverse_document_freqs.SetDocumentFreq(term_id, document_freqs_[term_id]);
+    }
+    inverse_document_freqs.SetDocumentCount(GetDocumentCount());
+    inverse_document_freqs_ = std::move(inverse_document_freqs);
+    ++generation_;
+}
+
+IdfConsistency SearchServer::GetIdfConsistency() const noexcept {
+    return inverse_document_freqs_.GetConsistency();
+}
+
+void SearchServer::SetPostingFormat(PostingFormat format) {
+    WaitForMerges();
+    posting_format_ = format;
+    mutable_segment_.SetFormat(format);
+    for (SealedSegment& sealed : sealed_segments_) {
+        if (sealed.segment->GetFormat() != format) {
+            auto segment = std::make_shared<IndexSegment>(*sealed.segment);
+            segment->SetFormat(format);
+            sealed.segment = std::move(segment);
+        }
+    }
+}
+
+PostingFormat SearchServer::GetPostingFormat() const noexcept {
+    return posting_format_;
+}
+
+void SearchServer::SetPositionIndexing(bool enabled) {
+    if (enabled == is_position_indexing_) {
+        return;
+    }
+    if (enabled && documents_.GetNumberCount() > 0) {
+        throw std::logic_error(std::string{ "position indexing can only be enabled on an empty server" });
+    }
+    is_position_indexing_ = enabled;
+    positions_.clear();
+    ++generation_;
+}
+
+bool SearchServer::GetPositionIndexing() const noexcept {
+    return is_position_indexing_;
+}
+
+void SearchServer::SetProximityWeight(double weight) {
+    if (!(weight >= 0.0)) {
+        throw std::invalid_argument(std::string{ "proximity weight must be non-negative" });
+    }
+    proximity_weight_ = weight;
+    ++generation_;
+}
+
+double SearchServer::GetProximityWeight() const noexcept {
+    return proximity_weight_;
+}
+
+void SearchServer::SetMaxPrefixExpansion(size_t max_term_count) {
+    if (max_term_count == 0) {
+        throw std::invalid_argument(std::string{ "prefix expansion limit must be positive" });
+    }
+    max_prefix_expansion_ = max_term_count;
+    ++generation_;
+}
+
+size_t SearchServer::GetMaxPrefixExpansion() const noexcept {
+    return max_prefix_expansion_;
+}
+
+void SearchServer::SetMaxEditDistance(size_t max_distance) {
+    if (max_distance > MAX_EDIT_DISTANCE) {
+        throw std::invalid_argument(std::string{ "edit distance must not exceed 2" });
+    }
+    max_edit_distance_ = max_distance;
+    ++generation_;
+}
+
+size_t SearchServer::GetMaxEditDistance() const noexcept {
+    return max_edit_distance_;
+}
+
+void SearchServer::SetMaxSegmentDocumentCount(size_t max_segment_document_count) {
+    max_segment_document_count_ = std::max<size_t>(max_segment_document_count, 1);
+    if (mutable_segment_.GetDocumentCount() >= max_segment_document_count_) {
+        SealMutableSegment();
+    }
+}
+
+size_t SearchServer::GetSegmentCount() const noexcept {
+    return sealed_segments_.size() + 1;
+}
+
+size_t SearchServer::GetDocumentNumberCount() const noexcept {
+    return static_cast<size_t>(documents_.GetNumberCount());
+}
+
+void SearchServer::WaitForMerges() {
+    while (merge_) {
+        merge_->result.wait();
+        InstallMerge();
+        ScheduleMerge();
+    }
+}
+
+void SearchServer::SetResultCacheCapacity(size_t capacity_bytes) {
+    result_cache_ = capacity_bytes > 0 ? std::make_unique<QueryResultCache>(capacity_bytes) : nullptr;
+}
+
+size_t SearchServer::GetResultCacheSize() const {
+    return result_cache_ ? result_cache_->size() : 0;
+}
+
+void SearchServer::SetMaxResultDocumentCount(size_t result_count) noexcept {
+    max_result_document_count_ = result_count;
+}
+
+size_t SearchServer::GetMaxResultDocumentCount() const noexcept {
+    return max_result_document_count_;
+}
+
+int SearchServer::GetDocumentCount() const noexcept {
+    return documents_.size();
+}
+
+uint64_t SearchServer::GetTotalDocumentLength() const noexcept {
+    return documents_.GetTotalLength();
+}
+
+size_t SearchServer::GetDocumentFreq(std::string_view word) const {
+    const TermDictionary::TermId term_id = FindIndexedTerm(word);
+    return term_id == TermDictionary::NO_TERM ? 0 : document_freqs_[term_id];
+}
+
+std::set<int>::const_iterator SearchServer::begin() const noexcept {
+    return documents_.begin();
+}
+
+std::set<int>::const_iterator SearchServer::end() const noexcept {
+    return documents_.end();
+}
+
+const std::map<std::string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
+    if (const int document_number = documents_.FindNumber(document_id); document_number >= 0) {
+        return document_word_freqs_[document_number];
+    }
+    static std::map<std::string_view, double> empty;
+    return  empty;
+}
+
+void SearchServer::RemoveDocument(int document_id) {
+    RemoveDocument(std::execution::seq, document_id);
+}
+
+void SearchServer::RemoveDocuments(const std::vector<int>& document_ids) {
+    RemoveDocuments(std::execution::seq, document_ids);
+}
+
+void SearchServer::MarkDocumentDeleted(int document_number) {
+    auto& word_freqs = document_word_freqs_[document_number];
+    if (!word_freqs.empty()) {
+        const TermDictionary::TermId any_term_id = terms_.Find(word_freqs.begin()->first);
+        const PostingList* postings = mutable_segment_.FindPostings(any_term_id);
+        if (postings != nullptr && postings->Contains(document_number)) {
+            ++mutable_deleted_count_;
+        }
+        else {
+            for (SealedSegment& sealed : sealed_segments_) {
+                postings = sealed.segment->FindPostings(any_term_id);
+                if (postings != nullptr && postings->Contains(document_number)) {
+                    ++sealed.deleted_count;
+                    break;
+                }
+            }
+        }
+    }
+    std::map<std::string_view, double>{}.swap(word_freqs);
+    positions_.Remove(document_number);
+    documents_.Remove(document_number);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument( std::string_view raw_query, int document_id) const {
+    return MatchDocument(std::execution::seq, raw_query, document_id);
+}
+
+TermDictionary::TermId SearchServer::FindIndexedTerm(std::string_view word) const {
+    const TermDictionary::TermId term_id = terms_.Find(word);
+    if (term_id == TermDictionary::NO_TERM || document_freqs_[term_id] == 0) {
+        return TermDictionary::NO_TERM;
+    }
+    return term_id;
+}
+
+bool SearchServer::IsTermInDocument(TermDictionary::TermId term_id, int document_number) const {
+    bool is_found = false;
+    ForEachSegment([term_id, document_number, &is_found](const IndexSegment& segment) {
+        const PostingList* postings = segment.FindPostings(term_id);
+        is_found = is_found || (postings != nullptr && postings->Contains(document_number));
+    });
+    return is_found && documents_.IsAlive(document_number);
+}
+
+void SearchServer::SealMutableSegment() {
+    if (mutable_segment_.GetDocumentCount() == 0) {
+        return;
+    }
+    sealed_segments_.push_back({ std::make_shared<const IndexSegment>(std::move(mutable_segment_)), mutable_deleted_count_ });
+    mutable_segment_ = IndexSegment(posting_format_);
+    mutable_deleted_count_ = 0;
+    ScheduleMerge();
+}
+
+void SearchServer::CompactDocumentNumbers() {
+    const size_t deleted_count = static_cast<size_t>(documents_.GetNumberCount()) - documents_.size();
+    if (deleted_count < MIN_COMPACTED_NUMBER_COUNT || deleted_count <= documents_.size()) {
+        return;
+    }
+    // слияние идёт в старой нумерации: его результат подключается и перенумеровывается вместе с остальными
+    if (merge_) {
+        InstallMerge();
+    }
+    // нумерация сохраняет порядок, поэтому постинги, позиции и частоты слов остаются упорядоченными по номерам
+    const std::vector<int> new_numbers = documents_.Compact();
+    mutable_segment_ = IndexSegment::Renumber(mutable_segment_, new_numbers,
+        mutable_segment_.GetDocumentCount() - mutable_deleted_count_, posting_format_);
+    mutable_deleted_count_ = 0;
+    std::vector<SealedSegment> sealed_segments;
+    for (const SealedSegment& sealed : sealed_segments_) {
+        const size_t document_count = sealed.segment->GetDocumentCount() - sealed.deleted_count;
+        if (document_count > 0) {
+            sealed_segments.push_back({ std::make_shared<const IndexSegment>(
+                IndexSegment::Renumber(*sealed.segment, new_numbers, document_count, posting_format_)), 0 });
+        }
+    }
+    sealed_segments_ = std::move(sealed_segments);
+    std::vector<std::map<std::string_view, double>> document_word_freqs;
+    document_word_freqs.reserve(documents_.size());
+    for (size_t document_number = 0; document_number < new_numbers.size(); ++document_number) {
+        if (new_numbers[document_number] >= 0) {
+            document_word_freqs.push_back(std::move(document_word_freqs_[document_number]));
+        }
+    }
+    document_word_freqs_ = std::move(document_word_freqs);
+    positions_.Renumber(new_numbers);
+}
+
+void SearchServer::PollMerge() {
+    if (merge_ && merge_->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        InstallMerge();
+        ScheduleMerge();
+    }
+}
+
+void SearchServer::InstallMerge() {
+    SealedSegment merged{ merge_->result.get(), 0 };
+    for (size_t i = 0; i < merge_->sources.size(); ++i) {
+        const auto source = std::find_if(sealed_segments_.begin(), sealed_segments_.end(), [this, i](const SealedSegment& sealed) {
+            return sealed.segment == merge_->sources[i];
+        });
+        // документы, удалённые во время слияния, остаются в результате надгробиями
+        merged.deleted_count += source->deleted_count - merge_->deleted_counts[i];
+        sealed_segments_.erase(source);
+    }
+    merge_.reset();
+    if (merged.segment->GetDocumentCount() > merged.deleted_count) {
+        sealed_segments_.push_back(std::move(merged));
+    }
+}
+
+void SearchServer::ScheduleMerge() {
+    if (merge_) {
+        return;
+    }
+    std::vector<size_t> sources;
+    // сегмент, в котором удалена хотя бы половина документов, переписывается сам по себе
+    for (size_t i = 0; i < sealed_segments_.size() && sources.empty(); ++i) {
+        if (sealed_segments_[i].deleted_count * 2 >= sealed_segments_[i].segment->GetDocumentCount()) {
+            sources.push_back(i);
+        }
+    }
+    // иначе сливаются SEGMENT_MERGE_FACTOR сегментов самого мелкого уровня, где их набралось столько;
+    // каждый документ переписывается O(log N) раз
+    if (sources.empty()) {
+        std::map<size_t, std::vector<size_t>> levels;
+        for (size_t i = 0; i < sealed_segments_.size(); ++i) {
+            size_t level = 0;
+            for (size_t bound = max_segment_document_count_ * SEGMENT_MERGE_FACTOR;
+                sealed_segments_[i].segment->GetDocumentCount() > bound && level < 32; bound *= SEGMENT_MERGE_FACTOR) {
+                ++level;
+            }
+            levels[level].push_back(i);
+        }
+        for (const auto& [level, segments] : levels) {
+            if (segments.size() >= SEGMENT_MERGE_FACTOR) {
+                sources.assign(segments.begin(), segments.begin() + SEGMENT_MERGE_FACTOR);
+                break;
+            }
+        }
+    }
+    if (sources.empty()) {
+        return;
+    }
+
+    SegmentMerge merge;
+    size_t document_count = 0;
+    for (const size_t i : sources) {
+        merge.sources.push_back(sealed_segments_[i].segment);
+        merge.deleted_counts.push_back(sealed_segments_[i].deleted_count);
+        document_count += sealed_segments_[i].segment->GetDocumentCount() - sealed_segments_[i].deleted_count;
+    }
+    // поток слияния читает только запечатанные сегменты и копию маски неудалённых документов
+    merge.result = std::async(std::launch::async, [sources = merge.sources, alive = documents_.GetAliveBits(),
+        document_count, format = posting_format_]() {
+        return std::make_shared<const IndexSegment>(IndexSegment::Merge(sources, alive, document_count, format));
+    });
+    merge_ = std::move(merge);
+}
+
+namespace {
+    struct SnapshotWordFreq {
+        uint32_t term_id;
+        uint32_t reserved;
+        double term_freq;
+    };
+
+    static_assert(sizeof(Posting) == 16 && offsetof(Posting, document_id) == 0 && offsetof(Posting, term_freq) == 8,
+        "snapshot stores postings as is");
+}
+
+void SearchServer::SaveSnapshot(const std::string& path) const {
+    SnapshotWriter writer;
+    writer.Write<uint64_t>(max_result_document_count_);
+    writer.Write<uint32_t>(static_cast<uint32_t>(inverse_document_freqs_.GetConsistency()));
+    writer.Write<uint32_t>(static_cast<uint32_t>(posting_format_));
+    writer.Write<uint32_t>(is_position_indexing_ ? 1 : 0);
+
+    writer.Write<uint64_t>(stop_words_.size());
+    for (size_t i = 0; i < stop_words_.size(); ++i) {
+        const std::string_view word = stop_words_.GetWord(i);
+        writer.Write<uint64_t>(word.size());
+        writer.WriteBytes(word);
+    }
+
+    const size_t term_count = terms_.size();
+    writer.Write<uint64_t>(term_count);
+    std::vector<uint64_t> offsets(term_count + 1, 0);
+    for (TermDictionary::TermId term_id = 0; term_id < term_count; ++term_id) {
+        offsets[term_id + 1] = offsets[term_id] + terms_.GetTerm(term_id).size();
+    }
+    writer.WriteArray(offsets.data(), offsets.size());
+    for (TermDictionary::TermId term_id = 0; term_id < term_count; ++term_id) {
+        writer.WriteBytes(terms_.GetTerm(term_id));
+    }
+
+    // номера документов в снимке идут подряд: удалённые номера пропускаются
+    std::vector<int> snapshot_numbers(documents_.GetNumberCount(), -1);
+    std::vector<int> live_numbers;
+    live_numbers.reserve(documents_.size());
+    for (int document_number = 0; document_number < documents_.GetNumberCount(); ++document_number) {
+        if (documents_.FindNumber(documents_.GetDocumentId(document_number)) == document_number) {
+            snapshot_numbers[document_number] = static_cast<int>(live_numbers.size());
+            live_numbers.push_back(document_number);
+        }
+    }
+
+    // сегменты сводятся в один; в снимке постинги всегда несжатые,
+    // чтобы их можно было читать из отображения без копирования
+    std::vector<double> max_term_freqs(term_count, 0.0);
+    std::vector<std::vector<Posting>> postings(term_count);
+    ForEachSegment([&max_term_freqs, &postings, &snapshot_numbers](const IndexSegment& segment) {
+        for (TermDictionary::TermId term_id = 0; term_id < segment.GetTermCount(); ++term_id) {
+            const PostingList* term_postings = segment.FindPostings(term_id);
+            if (term_postings == nullptr) {
+                continue;
+            }
+            max_term_freqs[term_id] = std::max(max_term_freqs[term_id], term_postings->GetMaxTermFreq());
+            for (PostingCursor cursor(*term_postings); !cursor.IsEnd(); cursor.Next()) {
+                if (snapshot_numbers[cursor->document_id] >= 0) {
+                    postings[term_id].push_back({ snapshot_numbers[cursor->document_id], cursor->term_freq });
+                }
+            }
+        }
+    });
+    for (TermDictionary::TermId term_id = 0; term_id < term_count; ++term_id) {
+        std::sort(postings[term_id].begin(), postings[term_id].end(), [](const Posting& lhs, const Posting& rhs) {
+            return lhs.document_id < rhs.document_id;
+        });
+        offsets[term_id + 1] = offsets[term_id] + postings[term_id].size();
+    }
+    writer.WriteArray(offsets.data(), offsets.size());
+    writer.WriteArray(max_term_freqs.data(), max_term_freqs.size());
+    // постинги читаются из отображения как Posting, но пишутся по полям: байты выравнивания
+    // после document_id не определены, а снимки одного индекса должны совпадать побайтно
+    writer.Align();
+    for (const std::vector<Posting>& term_postings : postings) {
+        for (const Posting& posting : term_postings) {
+            writer.Write<int32_t>(posting.document_id);
+            writer.Write<uint32_t>(0);
+            writer.Write<double>(posting.term_freq);
+        }
+    }
+
+    // документы в порядке номеров снимка
+    writer.Write<uint64_t>(live_numbers.size());
+    for (const int document_number : live_numbers) {
+        const auto& word_freqs = document_word_freqs_[document_number];
+        writer.Write<int32_t>(documents_.GetDocumentId(document_number));
+        writer.Write<int32_t>(documents_.GetRating(document_number));
+        writer.Write<int32_t>(static_cast<int32_t>(documents_.GetStatus(document_number)));
+        writer.Write<uint32_t>(documents_.GetLength(document_number));
+        writer.Write<uint32_t>(static_cast<uint32_t>(word_freqs.size()));
+        std::vector<SnapshotWordFreq> snapshot_word_freqs;
+        snapshot_word_freqs.reserve(word_freqs.size());
+        for (const auto& [word, term_freq] : word_freqs) {
+            snapshot_word_freqs.push_back({ terms_.Find(word), 0, term_freq });
+        }
+        writer.WriteArray(snapshot_word_freqs.data(), snapshot_word_freqs.size());
+        if (is_position_indexing_) {
+            const PositionIndex::DocumentPositions positions = positions_.Get(document_number);
+            writer.Write<uint32_t>(static_cast<uint32_t>(positions.term_ids.size()));
+            writer.WriteArray(positions.term_ids.data(), positions.term_ids.size());
+            writer.WriteArray(positions.offsets.data(), positions.offsets.size());
+            writer.WriteArray(positions.data.data(), positions.data.size());
+        }
+    }
+    writer.SaveToFile(path);
+}
+
+SearchServer SearchServer::LoadSnapshot(const std::string& path) {
+    auto snapshot = std::make_shared<const MappedFile>(path);
+    SnapshotReader reader(*snapshot);
+
+    const auto max_result_document_count = reader.Read<uint64_t>();
+    const auto idf_consistency = reader.Read<uint32_t>();
+    if (idf_consistency > static_cast<uint32_t>(IdfConsistency::INCREMENTAL)) {
+        throw std::runtime_error(std::string{ "snapshot is corrupted: invalid IDF mode" });
+    }
+    const auto posting_format = reader.Read<uint32_t>();
+    if (posting_format > static_cast<uint32_t>(PostingFormat::COMPRESSED)) {
+        throw std::runtime_error(std::string{ "snapshot is corrupted: invalid posting format" });
+    }
+    const auto position_indexing = reader.Read<uint32_t>();
+    if (position_indexing > 1) {
+        throw std::runtime_error(std::string{ "snapshot is corrupted: invalid position indexing flag" });
+    }
+    const auto stop_word_count = reader.Read<uint64_t>();
+    std::vector<std::string_view> stop_words;
+    for (uint64_t i = 0; i < stop_word_count; ++i) {
+        stop_words.push_back(reader.ReadBytes(reader.Read<uint64_t>()));
+    }
+
+    SearchServer server(stop_words);
+    server.SetPositionIndexing(position_indexing == 1);
+    server.snapshot_ = snapshot;
+    server.max_result_document_count_ = max_result_document_count;
+
+    const auto term_count = reader.Read<uint64_t>();
+    const uint64_t* term_offsets = reader.ReadArray<uint64_t>(term_count + 1);
+    const std::string_view term_bytes = reader.ReadBytes(term_offsets[term_count]);
+    for (uint64_t term_id = 0; term_id < term_count; ++term_id) {
+        if (term_offsets[term_id] > term_offsets[term_id + 1] || term_offsets[term_id + 1] > term_bytes.size()
+            || server.terms_.InternExternal(term_bytes.substr(term_offsets[term_id], term_offsets[term_id + 1] - term_offsets[term_id])) != term_id) {
+            throw std::runtime_error(std::string{ "snapshot is corrupted: invalid term dictionary" });
+        }
+    }
+
+    const uint64_t* posting_offsets = reader.ReadArray<uint64_t>(term_count + 1);
+    const double* max_term_freqs = reader.ReadArray<double>(term_count);
+    const Posting* postings = reader.ReadArray<Posting>(posting_offsets[term_count]);
+    std::vector<PostingList> term_postings;
+    term_postings.reserve(term_count);
+    server.document_freqs_.reserve(term_count);
+    for (uint64_t term_id = 0; term_id < term_count; ++term_id) {
+        if (posting_offsets[term_id] > posting_offsets[term_id + 1] || posting_offsets[term_id + 1] > posting_offsets[term_count]) {
+            throw std::runtime_error(std::string{ "snapshot is corrupted: invalid posting offsets" });
+        }
+        term_postings.push_back(PostingList::View(postings + posting_offsets[term_id],
+            posting_offsets[term_id + 1] - posting_offsets[term_id], max_term_freqs[term_id]));
+        server.document_freqs_.push_back(term_postings.back().size());
+    }
+
+    const auto document_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < document_count; ++i) {
+        const auto document_id = reader.Read<int32_t>();
+        const auto rating = reader.Read<int32_t>();
+        const auto status = reader.Read<int32_t>();
+        const auto length = reader.Read<uint32_t>();
+        const auto word_count = reader.Read<uint32_t>();
+        const SnapshotWordFreq* snapshot_word_freqs = reader.ReadArray<SnapshotWordFreq>(word_count);
+        if (status < 0 || status > static_cast<int32_t>(DocumentStatus::REMOVED) || document_id < 0 || server.documents_.Contains(document_id)
+            || length < word_count) {
+            throw std::runtime_error(std::string{ "snapshot is corrupted: invalid document" });
+        }
+        const int document_number = server.documents_.Add(document_id, static_cast<DocumentStatus>(status), rating, length);
+        auto& word_freqs = server.document_word_freqs_.emplace_back();
+        for (uint32_t j = 0; j < word_count; ++j) {
+            if (snapshot_word_freqs[j].term_id >= term_count) {
+                throw std::runtime_error(std::string{ "snapshot is corrupted: invalid term id" });
+            }
+            word_freqs.emplace_hint(word_freqs.end(), server.terms_.GetTerm(snapshot_word_freqs[j].term_id), snapshot_word_freqs[j].term_freq);
+        }
+        if (server.is_position_indexing_) {
+            PositionIndex::DocumentPositions positions;
+            const auto position_term_count = reader.Read<uint32_t>();
+            const TermDictionary::TermId* term_ids = reader.ReadArray<TermDictionary::TermId>(position_term_count);
+            const uint32_t* offsets = reader.ReadArray<uint32_t>(position_term_count + size_t{ 1 });
+            const uint8_t* data = reader.ReadArray<uint8_t>(offsets[position_term_count]);
+            for (uint32_t j = 0; j < position_term_count; ++j) {
+                if (term_ids[j] >= term_count || offsets[0] != 0 || offsets[j] > offsets[j + 1] || (j > 0 && term_ids[j - 1] >= term_ids[j])) {
+                    throw std::runtime_error(std::string{ "snapshot is corrupted: invalid positions" });
+                }
+            }
+            positions.term_ids.assign(term_ids, term_ids + position_term_count);
+            positions.offsets.assign(offsets, offsets + position_term_count + 1);
+            positions.data.assign(data, data + offsets[position_term_count]);
+            server.positions_.Add(document_number, std::move(positions));
+        }
+    }
+    if (!reader.IsEnd()) {
+        throw std::runtime_error(std::string{ "snapshot is corrupted: trailing data" });
+    }
+
+    // снимок загружается одним запечатанным сегментом
+    size_t indexed_document_count = 0;
+    for (const auto& word_freqs : server.document_word_freqs_) {
+        indexed_document_count += word_freqs.empty() ? 0 : 1;
+    }
+    server.sealed_segments_.push_back({ std::make_shared<const IndexSegment>(std::move(term_postings), indexed_document_count), 0 });
+    server.SetIdfConsistency(static_cast<IdfConsistency>(idf_consistency));
+    server.SetPostingFormat(static_cast<PostingFormat>(posting_format));
+    return server;
+}
+
+bool SearchServer::IsStopWord(std::string_view word) const {
+    return stop_words_.Contains(word);
+}
+
+SearchServer::CheckedStopWords SearchServer::SplitStopWords(std::string_view stop_words_text) {
+    CheckedStopWords stop_words;
+    if (!SplitIntoWords(stop_words_text, stop_words.words)) {
+        throw std::invalid_argument("стоп слова содержат специальные символы с кодом от 0 до 31"s);
+    }
+    return stop_words;
+}
+
+bool SearchServer::CheckingForSpecialSymbols(const std::string_view& s) {
+    return ContainsControlCharacters(s);
+}
+
+std::vector<std::string_view> SearchServer::SplitIntoWordsNoStop(const std::string_view& text) const {
+    std::vector<std::string_view> words;
+    if (!SplitIntoWords(text, words)) {
+        throw std::invalid_argument(std::string{ "Word  is invalid" });
+    }
+    words.erase(std::remove_if(words.begin(), words.end(), [this](std::string_view word) {
+        return IsStopWord(word);
+    }), words.end());
+    return words;
+}
+
+std::vector<std::pair<std::string_view, double>> SearchServer::ComputeWordFreqs(const std::string_view& text, uint32_t& word_count,
+    std::vector<std::vector<uint32_t>>* word_positions) const {
+    if (word_positions == nullptr) {
+        std::vector<std::string_view> words = SplitIntoWordsNoStop(text);
+        std::sort(words.begin(), words.end());
+        word_count = static_cast<uint32_t>(words.size());
+
+        const double inv_word_count = 1.0 / words.size();
+        std::vector<std::pair<std::string_view, double>> word_freqs;
+        for (const std::string_view word : words) {
+            if (word_freqs.empty() || word_freqs.back().first != word) {
+                word_freqs.emplace_back(word, 0.0);
+            }
+            word_freqs.back().second += inv_word_count;
+        }
+        return word_freqs;
+    }
+
+    // позиции считаются по всем словам текста, включая стоп-слова
+    std::vector<std::string_view> all_words;
+    if (!SplitIntoWords(text, all_words)) {
+        throw std::invalid_argument(std::string{ "Word  is invalid" });
+    }
+    std::vector<std::pair<std::string_view, uint32_t>> words;
+    for (size_t position = 0; position < all_words.size(); ++position) {
+        if (!IsStopWord(all_words[position])) {
+            words.emplace_back(all_words[position], static_cast<uint32_t>(position));
+        }
+    }
+    std::sort(words.begin(), words.end());
+    word_count = static_cast<uint32_t>(words.size());
+
+    const double inv_word_count = 1.0 / words.size();
+    std::vector<std::pair<std::string_view, double>> word_freqs;
+    word_positions->clear();
+    for (const auto& [word, position] : words) {
+        if (word_freqs.empty() || word_freqs.back().first != word) {
+            word_freqs.emplace_back(word, 0.0);
+            word_positions->emplace_back();
+        }
+        word_freqs.back().second += inv_word_count;
+        word_positions->back().push_back(position);
+    }
+    return word_freqs;
+}
+
+void SearchServer::CheckNewDocumentId(int document_id) const {
+    if (document_id < 0) {
+        throw std::invalid_argument(std::string{ "id документа должен быть >= 0!" });
+    }
+    if (documents_.Contains(document_id)) {
+        throw std::invalid_argument(std::string{ "документ с таким id уже существует!" });
+    }
+}
+
+int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
+    if (ratings.empty()) {
+        return 0;
+    }
+    int rating_sum = 0;
+    for (const int rating : ratings) {
+        rating_sum += rating;
+    }
+    return rating_sum / static_cast<int>(ratings.size());
+}
+
+namespace {
+    thread_local bool query_buffer_in_use = false;
+}
+
+SearchServer::QueryBuffer::QueryBuffer() {
+    thread_local Query query;
+    if (query_buffer_in_use) {
+        own_query_ = std::make_unique<Query>();
+        query_ = own_query_.get();
+    }
+    else {
+        query_buffer_in_use = true;
+        query_ = &query;
+    }
+}
+
+SearchServer::QueryBuffer::~QueryBuffer() {
+    if (!own_query_) {
+        query_buffer_in_use = false;
+    }
+}
+
+SearchServer::Query& SearchServer::QueryBuffer::Get() noexcept {
+    return *query_;
+}
+
+void SearchServer::ParseQuery(std::string_view text, Query& query) const {
+    query.plus_words.clear();
+    query.minus_words.clear();
+    query.words.clear();
+    query.phrase_words.clear();
+    query.phrase_ends.clear();
+    query.fuzzy_terms.clear();
+    if (!SplitIntoWords(text, query.words)) {
+        throw std::invalid_argument(std::string{ "invalid query special symbols" });
+    }
+    bool is_in_phrase = false;
+    uint32_t phrase_position = 0;
+    for (std::string_view word : query.words) {
+        // кавычка в начале слова открывает фразу, в конце - закрывает. Без позиционного индекса
+        // кавычки - обычные символы слова, как и до появления фраз
+        if (is_position_indexing_ && word.front() == '"') {
+            if (is_in_phrase) {
+                throw std::invalid_argument(std::string{ "invalid query nested phrase" });
+            }
+            word.remove_prefix(1);
+            is_in_phrase = true;
+            phrase_position = 0;
+        }
+        const bool is_phrase_end = is_in_phrase && !word.empty() && word.back() == '"';
+        if (is_phrase_end) {
+            word.remove_suffix(1);
+        }
+        if (word.empty()) {
+            throw std::invalid_argument(std::string{ "invalid query empty phrase word" });
+        }
+        if (is_in_phrase) {
+            if (word.front() == '-') {
+                throw std::invalid_argument(std::string{ "invalid query minus word in phrase" });
+            }
+            if (word.size() > 1 && word.back() == '*') {
+                throw std::invalid_argument(std::string{ "invalid query prefix word in phrase" });
+            }
+            // стоп-слово внутри фразы занимает позицию, а по краям фразы ничего не требует: перед первым
+            // словом позиция не растёт, а после последнего позиции не проверяются
+            const size_t phrase_begin = query.phrase_ends.empty() ? 0 : query.phrase_ends.back();
+            if (!IsStopWord(word)) {
+                query.plus_words.push_back(word);
+                query.phrase_words.emplace_back(word, phrase_position);
+            }
+            if (query.phrase_words.size() > phrase_begin) {
+                ++phrase_position;
+            }
+            if (is_phrase_end) {
+                // фраза только из стоп-слов ничего не требует
+                if (query.phrase_words.size() > phrase_begin) {
+                    query.phrase_ends.push_back(query.phrase_words.size());
+                }
+                is_in_phrase = false;
+            }
+            continue;
+        }
+        if (word.find("--") != word.npos) {
+            throw std::invalid_argument(std::string{ "invalid query" });
+        }
+        // слово из одного минуса или с минусом на конце
+        if (word.back() == '-') {
+            throw std::invalid_argument(std::string{ "invalid query empty minus word" });
+        }
+        const bool is_minus = word.front() == '-';
+        if (is_minus) {
+            word.remove_prefix(1);
+        }
+        // одиночная звёздочка - обычное слово, как и до префиксных запросов
+        if (word.size() > 1 && word.back() == '*') {
+            word.remove_suffix(1);
+            ExpandPrefix(word, query, is_minus ? query.minus_words : query.plus_words);
+        }
+        else if (!IsStopWord(word)) {
+            (is_minus ? query.minus_words : query.plus_words).push_back(word);
+            if (!is_minus && max_edit_distance_ > 0) {
+                ExpandFuzzy(word, query);
+            }
+        }
+    }
+
+    if (is_in_phrase) {
+        throw std::invalid_argument(std::string{ "invalid query unterminated phrase" });
+    }
+
+    for (std::vector<std::string_view>* words : { &query.plus_words, &query.minus_words }) {
+        std::sort(words->begin(), words->end());
+        words->erase(std::unique(words->begin(), words->end()), words->end());
+    }
+
+    if (!query.fuzzy_terms.empty()) {
+        // терм, близкий к нескольким словам, остаётся с наименьшим расстоянием, а слово самого запроса
+        // нечётким не считается
+        std::sort(query.fuzzy_terms.begin(), query.fuzzy_terms.end(), [](const FuzzyTerm& lhs, const FuzzyTerm& rhs) {
+            return lhs.term < rhs.term || (lhs.term == rhs.term && lhs.distance < rhs.distance);
+        });
+        const auto is_same_term = [](const FuzzyTerm& lhs, const FuzzyTerm& rhs) {
+            return lhs.term == rhs.term;
+        };
+        query.fuzzy_terms.erase(std::unique(query.fuzzy_terms.begin(), query.fuzzy_terms.end(), is_same_term), query.fuzzy_terms.end());
+        const auto is_query_word = [&query](const FuzzyTerm& fuzzy) {
+            return std::binary_search(query.plus_words.begin(), query.plus_words.end(), fuzzy.term);
+        };
+        query.fuzzy_terms.erase(std::remove_if(query.fuzzy_terms.begin(), query.fuzzy_terms.end(), is_query_word), query.fuzzy_terms.end());
+        for (const FuzzyTerm& fuzzy : query.fuzzy_terms) {
+            query.plus_words.push_back(fuzzy.term);
+        }
+        std::sort(query.plus_words.begin(), query.plus_words.end());
+    }
+}
+
+void SearchServer::ExpandPrefix(std::string_view prefix, Query& query, std::vector<std::string_view>& words) const {
+    query.prefix_terms.clear();
+    terms_.ForEachWithPrefix(prefix, [this, &query](std::string_view, TermDictionary::TermId term_id) {
+        // термы, оставшиеся в словаре только от удалённых документов, не раскрываются
+        if (document_freqs_[term_id] > 0) {
+            query.prefix_terms.emplace_back(document_freqs_[term_id], terms_.GetTerm(term_id));
+        }
+    });
+    const auto is_more_frequent = [](const std::pair<size_t, std::string_view>& lhs, const std::pair<size_t, std::string_view>& rhs) {
+        return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+    };
+    if (query.prefix_terms.size() > max_prefix_expansion_) {
+        std::nth_element(query.prefix_terms.begin(), query.prefix_terms.begin() + max_prefix_expansion_, query.prefix_terms.end(), is_more_frequent);
+        query.prefix_terms.resize(max_prefix_expansion_);
+    }
+    for (const auto& [document_freq, term] : query.prefix_terms) {
+        words.push_back(term);
+    }
+}
+
+void SearchServer::ExpandFuzzy(std::string_view word, Query& query) const {
+    const size_t max_distance = std::min(max_edit_distance_, word.size() <= 2 ? size_t{ 0 } : word.size() <= 5 ? size_t{ 1 } : size_t{ 2 });
+    if (max_distance == 0) {
+        return;
+    }
+    LevenshteinAutomaton automaton(word, max_distance);
+    const size_t begin = query.fuzzy_terms.size();
+    terms_.ForEachAccepted(automaton, [this, &automaton, &query, word](std::string_view, TermDictionary::TermId term_id) {
+        if (const size_t distance = automaton.GetDistance(); distance > 0 && document_freqs_[term_id] > 0) {
+            query.fuzzy_terms.push_back({ terms_.GetTerm(term_id), word, distance, document_freqs_[term_id] });
+        }
+    });
+    // ближайшие, из равноудалённых - самые частые
+    const auto is_better = [](const FuzzyTerm& lhs, const FuzzyTerm& rhs) {
+        if (lhs.distance != rhs.distance) {
+            return lhs.distance < rhs.distance;
+        }
+        return lhs.document_freq > rhs.document_freq || (lhs.document_freq == rhs.document_freq && lhs.term < rhs.term);
+    };
+    if (query.fuzzy_terms.size() - begin > MAX_FUZZY_EXPANSION) {
+        std::nth_element(query.fuzzy_terms.begin() + begin, query.fuzzy_terms.begin() + begin + MAX_FUZZY_EXPANSION, query.fuzzy_terms.end(), is_better);
+        query.fuzzy_terms.resize(begin + MAX_FUZZY_EXPANSION);
+    }
+}
+
+const SearchServer::FuzzyTerm* SearchServer::FindFuzzyTerm(const Query& query, std::string_view term) {
+    const auto iter = std::lower_bound(query.fuzzy_terms.begin(), query.fuzzy_terms.end(), term, [](const FuzzyTerm& fuzzy, std::string_view value) {
+        return fuzzy.term < value;
+    });
+    return iter != query.fuzzy_terms.end() && iter->term == term ? &*iter : nullptr;
+}
+
+std::string SearchServer::MakeResultCacheKey(const Query& query, DocumentStatus status, size_t result_count) {
+    // слова не содержат символов с кодами 0..31, поэтому они служат разделителями
+    std::string key;
+    for (const std::string_view word : query.plus_words) {
+        key += word;
+        key += '\1';
+    }
+    key += '\2';
+    for (const std::string_view word : query.minus_words) {
+        key += word;
+        key += '\1';
+    }
+    key += '\2';
+    for (size_t i = 0, phrase = 0; i < query.phrase_words.size(); ++i) {
+        key += query.phrase_words[i].first;
+        key += '\1';
+        key += std::to_string(query.phrase_words[i].second);
+        key += '\1';
+        if (i + 1 == query.phrase_ends[phrase]) {
+            key += '\3';
+            ++phrase;
+        }
+    }
+    key += '\2';
+    // вес нечёткого терма зависит от расстояния и слова, к которому он близок
+    for (const FuzzyTerm& fuzzy : query.fuzzy_terms) {
+        key += fuzzy.term;
+        key += '\1';
+        key += fuzzy.word;
+        key += '\1';
+        key += std::to_string(fuzzy.distance);
+        key += '\3';
+    }
+    key += '\2';
+    key += std::to_string(static_cast<int>(status));
+    key += '\1';
+    key += std::to_string(result_count);
+    return key;
+}
+
+CollectionStatistics SearchServer::GetCollectionStatistics() const noexcept {
+    return { documents_.size(), documents_.GetAverageLength() };
+}
+
+bool SearchServer::ResolveQueryPhrases(const Query& query, QueryPhrases& phrases) const {
+    phrases.phrase_terms.clear();
+    for (const auto& [word, position] : query.phrase_words) {
+        const TermDictionary::TermId term_id = FindIndexedTerm(word);
+        if (term_id == TermDictionary::NO_TERM) {
+            return false;
+        }
+        phrases.phrase_terms.push_back({ term_id, position });
+    }
+    phrases.phrase_ends = query.phrase_ends;
+    return true;
+}
+
+bool SearchServer::ContainsPhrases(int document_number, const QueryPhrases& phrases) const {
+    const PositionIndex::PhraseTerm* phrase_terms = phrases.phrase_terms.data();
+    size_t phrase_begin = 0;
+    for (const size_t phrase_end : phrases.phrase_ends) {
+        if (!positions_.ContainsPhrase(document_number, phrase_terms + phrase_begin, phrase_terms + phrase_end)) {
+            return false;
+        }
+        phrase_begin = phrase_end;
+    }
+    return true;
+}
+
+bool SearchServer::IsProximityRanking(const Query& query) const noexcept {
+    return is_position_indexing_ && proximity_weight_ > 0.0 && query.plus_words.size() > 1;
+}
+
+void SearchServer::ApplyProximity(const Query& query, std::vector<Document>& documents) const {
+    std::vector<TermDictionary::TermId> term_ids;
+    for (const std::string_view word : query.plus_words) {
+        if (const TermDictionary::TermId term_id = FindIndexedTerm(word); term_id != TermDictionary::NO_TERM) {
+            term_ids.push_back(term_id);
+        }
+    }
+    for (Document& document : documents) {
+        size_t matched_count = 0;
+        const uint32_t min_span = positions_.FindMinSpan(documents_.FindNumber(document.id), term_ids, matched_count);
+        if (matched_count > 1) {
+            document.relevance *= 1.0 + proximity_weight_ * static_cast<double>(matched_count - 1) / static_cast<double>(min_span - 1);
+        }
+    }
+}
+
+std::vector<SearchServer::QueryTerms> SearchServer::ResolveSegmentTerms(const std::vector<std::pair<TermDictionary::TermId, double>>& plus_terms, const std::vector<TermDictionary::TermId>& minus_terms) const {
+    std::vector<QueryTerms> segment_terms;
+    ForEachSegment([&plus_terms, &minus_terms, &segment_terms](const IndexSegment& segment) {
+        QueryTerms query_terms;
+        for (const auto& [term_id, term_weight] : plus_terms) {
+            if (const PostingList* postings = segment.FindPostings(term_id)) {
+                query_terms.plus_terms.push_back({ postings, term_weight });
+                query_terms.plus_postings_count += postings->size();
+            }
+        }
+        if (query_terms.plus_terms.empty()) {
+            return;
+        }
+        for (const TermDictionary::TermId term_id : minus_terms) {
+            if (const PostingList* postings = segment.FindPostings(term_id)) {
+                query_terms.minus_postings.push_back(postings);
+            }
+        }
+        segment_terms.push_back(std::move(query_terms));
+    });
+    return segment_terms;
+}
+
+std::vector<std::pair<int, int>> SearchServer::SplitDocumentNumbers(size_t part_count) const {
+    if (documents_.size() == 0) {
+        return {};
+    }
+    const int last_number = documents_.GetNumberCount() - 1;
+    part_count = std::clamp<size_t>(part_count, 1, std::max(1u, std::thread::hardware_concurrency()));
+
+    const int64_t part_size = static_cast<int64_t>(last_number) / static_cast<int64_t>(part_count) + 1;
+    std::vector<std::pair<int, int>> number_ranges;
+    for (int64_t first = 0; first <= last_number; first += part_size) {
+        number_ranges.emplace_back(static_cast<int>(first), static_cast<int>(std::min<int64_t>(first + part_size - 1, last_number)));
+    }
+    return number_ranges;
+}
+
+double SearchServer::ComputeWordInverseDocumentFreq(TermDictionary::TermId term_id) const {
+    return inverse_document_freqs_.Get(term_id, document_freqs_[term_id]);
+}
+
+void PrintMatchDocumentResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status) {
+    std::cout << std::string{ "{ " }
+        << std::string{ "document_id = " } << document_id << std::string{ ", " }
+        << std::string{ "status = " } << static_cast<int>(status) << std::string{ ", " }
+    << std::string{ "words =" };
+    for (const std::string_view& word : words) {
+        std::cout << ' ' << word;
+    }
+    std::cout << std::string{ "}" } << std::endl;
+}
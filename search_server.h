@@ -1,239 +1,1130 @@
-#pragma once
-
-#include "string_processing.h"
-#include "document.h"
-#include "concurrent_map.h"
-#include "log_duration.h"
-
-#include <vector>
-#include <string>
-#include <stdexcept>
-#include <algorithm>
-#include <execution>
-#include <map>
-#include <mutex>
-#include <set>
-
-const int MAX_RESULT_DOCUMENT_COUNT = 5;
-
-using namespace std::string_literals;
-
-class SearchServer {
-public:
-    template <typename StringContainer>
-    explicit SearchServer(const StringContainer& stop_words)
-        : stop_words_(MakeUniqueNonEmptyStrings(stop_words)), server_work_time_("work"s)
-    {
-        for (const std::string& word : stop_words_) {
-            if (CheckingForSpecialSymbols(word)) {
-                throw std::invalid_argument("        0  31"s);
-            }
-        }
-    }
-
-    explicit SearchServer(const std::string& stop_words_text)
-        : SearchServer(SplitIntoWords(stop_words_text))
-    {
-    }
-
-    explicit SearchServer(const std::string_view& stop_words_text)
-        : SearchServer(SplitIntoWords(stop_words_text))
-    {
-    }
-
-    template <typename DocumentPredicate, typename ExecutionPolicy>
-    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const;
-    template <typename ExecutionPolicy>
-    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status) const;
-    template <typename ExecutionPolicy>
-    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query) const;
-    template <typename DocumentPredicate>
-    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const;
-    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const;
-    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query) const;
-
-    void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings);
-    
-    [[nodiscard]] int GetDocumentCount() const noexcept;
-
-    [[nodiscard]] std::set<int>::const_iterator begin() const noexcept;
-    [[nodiscard]] std::set<int>::const_iterator end() const noexcept;
-
-    [[nodiscard]] const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
-
-    template<typename ExecutionPolicy>
-    void RemoveDocument(ExecutionPolicy policy, int document_id);
-    void RemoveDocument(int document_id);
-
-    template<typename ExecutionPolicy>
-    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(ExecutionPolicy policy, std::string_view raw_query, int document_id) const;
-    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument( std::string_view raw_query, int document_id) const;
-
-private:
-    struct DocumentData {
-        int rating;
-        DocumentStatus status;
-    };
-
-    struct QueryWord {
-        std::string data;
-        bool is_minus;
-        bool is_stop;
-    };
-
-    struct Query {
-        std::set<std::string> plus_words;
-        std::set<std::string> minus_words;  
-    };
-
-
-    const std::set<std::string> stop_words_;
-    std::map<std::string, std::map<int, double>> word_to_document_freqs_;
-    std::map< int, std::map<std::string_view, double>> document_to_word_freqs_;
-    std::map<int, DocumentData> documents_;
-    std::set<int> document_ids_;
-    LogDuration server_work_time_;
-
-    template <typename DocumentPredicate, typename ExecutionPolicy>
-    [[nodiscard]] std::vector<Document> FindAllDocuments(ExecutionPolicy policy,const Query& query, DocumentPredicate document_predicate) const;
-
-    [[nodiscard]] bool IsContainWord(const std::string& word) const;
-    [[nodiscard]] bool IsWordContainId(const std::string& word, const int doc_id) const;
-
-    [[nodiscard]] bool IsStopWord(const std::string& word) const;
-
-    [[nodiscard]] static bool CheckingForSpecialSymbols(const std::string_view& s);
-
-    void ChekingRawQuery(const std::string_view& raw_query) const;
-
-    [[nodiscard]] std::vector<std::string> SplitIntoWordsNoStop(const std::string_view& text) const;
-
-    [[nodiscard]] static int ComputeAverageRating(const std::vector<int>& ratings);
-
-    [[nodiscard]] QueryWord ParseQueryWord( std::string_view text) const;
-    [[nodiscard]] Query ParseQuery( std::string_view text) const;
-
-    [[nodiscard]] double ComputeWordInverseDocumentFreq(const std::string& word) const;
-};
-
-template <typename DocumentPredicate, typename ExecutionPolicy>
-std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const {
-    ChekingRawQuery(raw_query);
-    const auto query = ParseQuery(raw_query);
-    auto matched_documents = FindAllDocuments(policy, query, document_predicate);
-    sort(policy, matched_documents.begin(), matched_documents.end(), [](const Document& lhs, const Document& rhs) {
-        if (std::abs(lhs.relevance - rhs.relevance) < 1e-6) {
-            return lhs.rating > rhs.rating;
-        }
-        else {
-            return lhs.relevance > rhs.relevance;
-        }
-    });
-    if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
-    }
-    return matched_documents;
-}
-
-template <typename ExecutionPolicy>
-[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status) const {
-        return FindTopDocuments(policy, raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-            return document_status == status;
-        });
-}
-
-template <typename ExecutionPolicy>
-[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query) const {
-    return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
-}
-
-template <typename DocumentPredicate>
-[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const {
-    return FindTopDocuments(std::execution::seq, raw_query, document_predicate);
-}
-
-template<typename ExecutionPolicy>
-void SearchServer::RemoveDocument(ExecutionPolicy policy, int document_id) {
-    if (auto iter = document_to_word_freqs_.find(document_id); iter != document_to_word_freqs_.end()) {
-        std::for_each(policy, iter->second.begin(), iter->second.end(),
-            [this, document_id](std::pair<const std::string_view, double>& word_freqs) {
-            std::string word = static_cast<std::string>(word_freqs.first);
-            word_to_document_freqs_.at(word).erase(document_id);
-            if (word_to_document_freqs_.at(word).empty()) {
-                word_to_document_freqs_.erase(word);
-            }
-        }
-        );
-        document_to_word_freqs_.erase(iter);
-        documents_.erase(document_id);
-        document_ids_.erase(document_id);
-    }
-}
-
-template<typename ExecutionPolicy>
-[[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(ExecutionPolicy policy, std::string_view raw_query, int document_id) const {
-    if (!document_ids_.count(document_id)){ //    std::count(document_ids_.begin(), document_ids_.end(), document_id)) {
-        throw std::out_of_range( "invalid document id "s);
-    }
-    ChekingRawQuery(raw_query);
-    const auto query = ParseQuery(raw_query);
-    std::vector<std::string_view> matched_words;
-
-    std::for_each(policy, query.plus_words.begin(), query.plus_words.end(),
-        [this, document_id, &matched_words](const std::string& word) {
-        if (word_to_document_freqs_.count(word)) {
-            if (word_to_document_freqs_.at(word).count(document_id)) {
-                matched_words.push_back(word_to_document_freqs_.find(word)->first);
-            }
-        }
-    });
-    std::for_each(policy, query.minus_words.begin(), query.minus_words.end(),
-        [this, document_id, &matched_words](const std::string& word) {
-        if (word_to_document_freqs_.count(word)) {
-            if (word_to_document_freqs_.at(word).count(document_id)) {
-                matched_words.clear();
-            }
-        }
-    });
-
-    return { matched_words, documents_.at(document_id).status };
-}
-
-template <typename DocumentPredicate, typename ExecutionPolicy>
-std::vector<Document> SearchServer::FindAllDocuments(ExecutionPolicy policy, const Query& query, DocumentPredicate document_predicate) const {
-
-    ConcurrentMap<int, double> document_to_relevance_con(4);
-    
-    std::for_each(policy, query.plus_words.begin(), query.plus_words.end(), [this, document_predicate, &document_to_relevance_con](const std::string& word) {
-        if (word_to_document_freqs_.count(word) != 0) {
-            for (const std::pair<int, double>& val : word_to_document_freqs_.at(word)) {
-                const auto& document_data = documents_.at(val.first);
-                if (document_predicate(val.first, document_data.status, document_data.rating)) {
-                    document_to_relevance_con[val.first].ref_to_value += val.second * ComputeWordInverseDocumentFreq(word);
-                }
-            }
-        }
-    });
-
-    std::map<int, double> document_to_relevance = std::move(document_to_relevance_con.BuildOrdinaryMap());
-
-    std::for_each(policy, query.minus_words.begin(), query.minus_words.end(), [this, &document_to_relevance](const std::string& word) {
-        if (word_to_document_freqs_.count(word) != 0) {
-            for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-                std::mutex delete_query;
-                std::lock_guard guard(delete_query);
-                document_to_relevance.erase(document_id);
-            }
-        }
-    }
-    );
-
-    std::vector<Document> matched_documents;
-
-    for (const auto [document_id, relevance] : document_to_relevance) {
-        matched_documents.push_back({ document_id, std::move(relevance), documents_.at(document_id).rating });
-    }
-    return matched_documents;
-}
-
+#pragma once
+
+#include "string_processing.h"
+#include "stop_word_set.h"
+#include "document.h"
+#include "document_store.h"
+#include "log_duration.h"
+#include "term_dictionary.h"
+#include "posting_list.h"
+#include "index_segment.h"
+#include "position_index.h"
+#include "relevance_accumulator.h"
+#include "inverse_document_freqs.h"
+#include "index_snapshot.h"
+#include "top_documents.h"
+#include "query_result_cache.h"
+#include "scoring_policy.h"
+#include "levenshtein_automaton.h"
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <execution>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+const int MAX_RESULT_DOCUMENT_COUNT = 5;
+
+template <typename ExecutionPolicy>
+[[nodiscard]] constexpr bool IsSequencedPolicy() noexcept {
+    return std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>;
+}
+
+using namespace std::string_literals;
+
+class SearchServer {
+public:
+    template <typename StringContainer>
+    explicit SearchServer(const StringContainer& stop_words)
+        : stop_words_(MakeUniqueNonEmptyStrings(stop_words)), server_work_time_("work"s)
+    {
+        for (size_t i = 0; i < stop_words_.size(); ++i) {
+            if (CheckingForSpecialSymbols(stop_words_.GetWord(i))) {
+                throw std::invalid_argument("стоп слова содержат специальные символы с кодом от 0 до 31"s);
+            }
+        }
+    }
+
+    // текст стоп-слов разбивается и проверяется на символы 0-31 за один проход
+    explicit SearchServer(const std::string& stop_words_text)
+        : SearchServer(SplitStopWords(stop_words_text))
+    {
+    }
+
+    explicit SearchServer(const std::string_view& stop_words_text)
+        : SearchServer(SplitStopWords(stop_words_text))
+    {
+    }
+
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate, size_t result_count) const;
+    template <typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status, size_t result_count) const;
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+    template <typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status) const;
+    template <typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query) const;
+    template <typename DocumentPredicate>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const;
+    [[nodiscard]] std::vector<Document> FindTopDocuments(const std::string_view& raw_query) const;
+
+    // Ранжирование политикой scoring (TfIdfScoring, Bm25Scoring или своей, см. scoring_policy.h)
+    // вместо TF-IDF по умолчанию. Политика - параметр шаблона, поэтому для каждой политики
+    // внутренние циклы поиска компилируются отдельно. Кэш результатов используется только для TfIdfScoring
+    template <typename ScoringPolicy, typename DocumentPredicate, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const;
+    template <typename ScoringPolicy, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status, size_t result_count, const ScoringPolicy& scoring) const;
+
+    // Пакет запросов по документам ACTUAL: слово, общее для нескольких запросов пакета,
+    // ищется в словаре и получает IDF один раз. Результаты дописываются в result
+    void FindTopDocumentsBatch(const std::vector<std::string_view>& raw_queries, DocumentBatch& result) const;
+
+    // пересчитывает IDF всех термов в новом режиме
+    void SetIdfConsistency(IdfConsistency consistency);
+    [[nodiscard]] IdfConsistency GetIdfConsistency() const noexcept;
+
+    // перекодирует постинг-листы всех термов; новые термы получают тот же формат
+    void SetPostingFormat(PostingFormat format);
+    [[nodiscard]] PostingFormat GetPostingFormat() const noexcept;
+
+    // Позиционный индекс для фразовых запросов (слова в кавычках: "curly cat") и близости слов.
+    // Стоп-слово внутри фразы совпадает с любым словом, а стоп-слова по краям фразы отбрасываются.
+    // Позиции строятся при добавлении документов, поэтому включить индекс можно только на пустом сервере.
+    // Без индекса кавычки в запросе - обычные символы слов
+    void SetPositionIndexing(bool enabled);
+    [[nodiscard]] bool GetPositionIndexing() const noexcept;
+
+    // Близость слов запроса: релевантность документа умножается на 1 + weight * (k - 1) / (span - 1),
+    // где k - число разных плюс-слов запроса в документе, span - длина наименьшего окна слов, где есть
+    // они все. Переранжируются PROXIMITY_CANDIDATE_FACTOR * K лучших по обычной релевантности.
+    // Работает при включённом позиционном индексе; 0 выключает
+    void SetProximityWeight(double weight);
+    [[nodiscard]] double GetProximityWeight() const noexcept;
+
+    // Слово запроса со звёздочкой на конце (cat*, -cat*; одиночная * - обычное слово) раскрывается в термы индекса с этим префиксом,
+    // и их постинги объединяются, как если бы все они были в запросе. Если таких термов больше
+    // max_term_count, берутся встречающиеся в наибольшем числе документов
+    void SetMaxPrefixExpansion(size_t max_term_count);
+    [[nodiscard]] size_t GetMaxPrefixExpansion() const noexcept;
+
+    // Нечёткий поиск: плюс-слово вне фраз раскрывается ещё и в термы индекса на расстоянии редактирования
+    // не больше max_distance (0 выключает, не больше 2). Короткие слова допускают меньше правок: в словах
+    // до 2 символов - ни одной, до 5 - одну. Термы находит автомат Левенштейна, обходя упорядоченный словарь,
+    // на слово берутся MAX_FUZZY_EXPANSION ближайших. Вес нечёткого терма не больше веса самого слова
+    // и умножается на FUZZY_WEIGHT_FACTOR за каждую правку, поэтому при равной частоте в документе
+    // точное совпадение ранжируется выше
+    void SetMaxEditDistance(size_t max_distance);
+    [[nodiscard]] size_t GetMaxEditDistance() const noexcept;
+
+    // Новые документы попадают в пишущийся сегмент; набрав max_segment_document_count документов,
+    // он запечатывается. Запечатанные сегменты сливаются в фоновом потоке, и при слиянии из них
+    // физически выбрасываются удалённые документы. Готовое слияние подключается при следующем изменении индекса.
+    // Когда удалённых документов становится больше, чем оставшихся (и не меньше MIN_COMPACTED_NUMBER_COUNT),
+    // неудалённые документы перенумеровываются подряд во всех сегментах, и номера удалённых освобождаются
+    void SetMaxSegmentDocumentCount(size_t max_segment_document_count);
+    [[nodiscard]] size_t GetSegmentCount() const noexcept;
+    // выданные внутренние номера документов, включая номера удалённых до сжатия нумерации
+    [[nodiscard]] size_t GetDocumentNumberCount() const noexcept;
+    // дожидается всех запланированных слияний
+    void WaitForMerges();
+
+    // Кэш результатов поиска по статусу; ключ - слова запроса без повторов и стоп-слов, статус
+    // и число результатов. Поиск с предикатом идёт мимо кэша. Добавление и удаление документов меняют
+    // число документов, а значит, IDF каждого терма, поэтому любое изменение индекса начинает
+    // новое поколение, и результаты прежних поколений не используются. capacity_bytes == 0 выключает кэш
+    void SetResultCacheCapacity(size_t capacity_bytes);
+    [[nodiscard]] size_t GetResultCacheSize() const;
+
+    void SetMaxResultDocumentCount(size_t result_count) noexcept;
+    [[nodiscard]] size_t GetMaxResultDocumentCount() const noexcept;
+
+    void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings);
+
+    // Пакетное добавление: документы разбираются параллельно, затем одним проходом
+    // вливаются в индекс. При ошибке в любом документе индекс не изменяется.
+    template <typename ExecutionPolicy>
+    void AddDocuments(ExecutionPolicy policy, const std::vector<NewDocument>& documents);
+    void AddDocuments(const std::vector<NewDocument>& documents);
+    
+    [[nodiscard]] int GetDocumentCount() const noexcept;
+    // Статистика для ранжирования по нескольким серверам: число нестоп-слов всех документов
+    // и число документов со словом word (0, если его нет в индексе)
+    [[nodiscard]] uint64_t GetTotalDocumentLength() const noexcept;
+    [[nodiscard]] size_t GetDocumentFreq(std::string_view word) const;
+
+    [[nodiscard]] std::set<int>::const_iterator begin() const noexcept;
+    [[nodiscard]] std::set<int>::const_iterator end() const noexcept;
+
+    [[nodiscard]] const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+
+    template<typename ExecutionPolicy>
+    void RemoveDocument(ExecutionPolicy policy, int document_id);
+    void RemoveDocument(int document_id);
+
+    // Пакетное удаление: частоты термов пересчитываются один раз на терм, отсутствующие id пропускаются
+    template <typename ExecutionPolicy>
+    void RemoveDocuments(ExecutionPolicy policy, const std::vector<int>& document_ids);
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+    template<typename ExecutionPolicy>
+    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(ExecutionPolicy policy, std::string_view raw_query, int document_id) const;
+    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument( std::string_view raw_query, int document_id) const;
+
+    // Снимок индекса: стоп-слова, словарь, постинги, документы и прямой индекс.
+    // Загруженный сервер отображает файл в память: термы и постинги читаются прямо из него,
+    // а в собственную память копируются только постинг-листы, которые потом изменяются.
+    void SaveSnapshot(const std::string& path) const;
+    [[nodiscard]] static SearchServer LoadSnapshot(const std::string& path);
+
+private:
+    // стоп-слова, уже проверенные на символы 0-31
+    struct CheckedStopWords {
+        std::vector<std::string_view> words;
+    };
+
+    explicit SearchServer(const CheckedStopWords& stop_words)
+        : stop_words_(MakeUniqueNonEmptyStrings(stop_words.words)), server_work_time_("work"s)
+    {
+    }
+
+    [[nodiscard]] static CheckedStopWords SplitStopWords(std::string_view stop_words_text);
+
+    // терм, найденный нечётким поиском по слову запроса word
+    struct FuzzyTerm {
+        std::string_view term;
+        std::string_view word;
+        size_t distance;
+        size_t document_freq;
+    };
+
+    // слова запроса без повторов и стоп-слов, упорядоченные; string_view указывают в текст запроса
+    struct Query {
+        std::vector<std::string_view> plus_words;
+        std::vector<std::string_view> minus_words;
+        // все слова текста запроса, буфер токенизатора
+        std::vector<std::string_view> words;
+        // слова фраз подряд с позицией внутри фразы (стоп-слова тоже занимают позиции);
+        // phrase_ends[i] - конец i-й фразы. Слова фраз входят и в plus_words
+        std::vector<std::pair<std::string_view, uint32_t>> phrase_words;
+        std::vector<size_t> phrase_ends;
+        // буфер раскрытия префикса: число документов терма и терм
+        std::vector<std::pair<size_t, std::string_view>> prefix_terms;
+        // нечёткие термы, упорядоченные по терму; они входят и в plus_words
+        std::vector<FuzzyTerm> fuzzy_terms;
+    };
+
+    // Запрос в буфере потока: векторы переиспользуются, поэтому разбор обычно не выделяет память.
+    // Если буфер потока занят (поток взял второй запрос, не закончив первый), запрос получает свой буфер.
+    class QueryBuffer {
+    public:
+        QueryBuffer();
+        QueryBuffer(const QueryBuffer&) = delete;
+        QueryBuffer& operator=(const QueryBuffer&) = delete;
+        ~QueryBuffer();
+
+        [[nodiscard]] Query& Get() noexcept;
+
+    private:
+        Query* query_;
+        std::unique_ptr<Query> own_query_;
+    };
+
+    // term_weight - вес слова запроса по политике ранжирования (для TF-IDF это IDF)
+    struct ScoredTerm {
+        const PostingList* postings;
+        double term_weight;
+    };
+
+    // слова запроса, разрешённые в постинг-листы одного сегмента; плюс-слова в порядке запроса.
+    // Удалённые из сегмента документы отсекаются как ещё одно минус-слово
+    struct QueryTerms {
+        std::vector<ScoredTerm> plus_terms;
+        std::vector<const PostingList*> minus_postings;
+        size_t plus_postings_count = 0;
+    };
+
+    // предикат статусных перегрузок FindTopDocuments: проверяется по битовой маске статуса,
+    // и документы с другим статусом пропускаются, не доходя до подсчёта релевантности
+    struct StatusFilter {
+        DocumentStatus status;
+    };
+
+    // фразы запроса, разрешённые в термы
+    struct QueryPhrases {
+        std::vector<PositionIndex::PhraseTerm> phrase_terms;
+        std::vector<size_t> phrase_ends;
+    };
+
+    struct QueryTask {
+        const QueryTerms* query_terms;
+        std::pair<int, int> id_range;
+    };
+
+    // постинги удалённых документов остаются в сегменте до слияния, deleted_count - их число
+    struct SealedSegment {
+        std::shared_ptr<const IndexSegment> segment;
+        size_t deleted_count = 0;
+    };
+
+    struct SegmentMerge {
+        std::vector<std::shared_ptr<const IndexSegment>> sources;
+        // deleted_count источников на момент запуска: удалённые позже переносятся в результат
+        std::vector<size_t> deleted_counts;
+        std::future<std::shared_ptr<const IndexSegment>> result;
+    };
+
+
+    // Отображение загруженного снимка: в него смотрят термы и постинги сегментов, в том числе
+    // из потока слияния. Объявлено первым, чтобы разрушаться последним, после ожидания слияния в merge_
+    std::shared_ptr<const MappedFile> snapshot_;
+    const StopWordSet stop_words_;
+    TermDictionary terms_;
+    // число документов с термом по всем сегментам
+    std::vector<size_t> document_freqs_;
+    InverseDocumentFreqs inverse_document_freqs_;
+    PostingFormat posting_format_ = PostingFormat::PLAIN;
+    IndexSegment mutable_segment_;
+    size_t mutable_deleted_count_ = 0;
+    std::vector<SealedSegment> sealed_segments_;
+    std::optional<SegmentMerge> merge_;
+    size_t max_segment_document_count_ = DEFAULT_MAX_SEGMENT_DOCUMENT_COUNT;
+    // Постинги, сегменты и поиск работают с плотными номерами документов из documents_
+    // (поле Posting::document_id хранит номер); внешние id возвращаются только в результатах
+    DocumentStore documents_;
+    // частоты слов по номеру документа; у удалённых карта пустая
+    std::vector<std::map<std::string_view, double>> document_word_freqs_;
+    size_t max_result_document_count_ = MAX_RESULT_DOCUMENT_COUNT;
+    std::unique_ptr<QueryResultCache> result_cache_;
+    // увеличивается при каждом изменении, после которого результаты поиска могут стать другими
+    uint64_t generation_ = 0;
+    bool is_position_indexing_ = false;
+    PositionIndex positions_;
+    double proximity_weight_ = 0.0;
+    size_t max_prefix_expansion_ = DEFAULT_MAX_PREFIX_EXPANSION;
+    size_t max_edit_distance_ = 0;
+    LogDuration server_work_time_;
+
+    // меньше постингов на задачу не даём: накладные расходы par съедят выигрыш
+    static constexpr size_t MIN_POSTINGS_PER_TASK = 1 << 14;
+    static constexpr size_t DEFAULT_MAX_SEGMENT_DOCUMENT_COUNT = 1 << 16;
+    // столько сегментов одного уровня сливаются в один сегмент следующего уровня
+    static constexpr size_t SEGMENT_MERGE_FACTOR = 4;
+    // меньше удалённых номеров не сжимаются: на маленьком индексе перенумерация не окупается
+    static constexpr size_t MIN_COMPACTED_NUMBER_COUNT = 1 << 10;
+    static constexpr size_t PROXIMITY_CANDIDATE_FACTOR = 4;
+    static constexpr size_t DEFAULT_MAX_PREFIX_EXPANSION = 64;
+    static constexpr size_t MAX_EDIT_DISTANCE = 2;
+    static constexpr size_t MAX_FUZZY_EXPANSION = 16;
+    static constexpr double FUZZY_WEIGHT_FACTOR = 0.5;
+
+    template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindAllDocuments(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, const ScoringPolicy& scoring) const;
+
+    template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocumentsPruned(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const;
+
+    template <typename DocumentPredicate, typename ScoringPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocumentsMaxScore(const QueryTerms& query_terms, DocumentPredicate& document_predicate, std::pair<int, int> id_range, size_t result_count, const ScoringPolicy& scoring) const;
+
+    // поиск по разобранному запросу: с фразами и близостью слов, если они есть
+    template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocumentsByQuery(ExecutionPolicy policy, const Query& query, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const;
+
+    template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocumentsByTerms(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const;
+
+    // плюс-термы с весами политики ранжирования и минус-термы, разложенные по сегментам
+    template <typename ScoringPolicy>
+    [[nodiscard]] std::vector<QueryTerms> ResolveQueryTerms(const Query& query, const ScoringPolicy& scoring) const;
+    [[nodiscard]] CollectionStatistics GetCollectionStatistics() const noexcept;
+    // вклад терма с весом term_weight в релевантность документа
+    template <typename ScoringPolicy>
+    [[nodiscard]] double ScorePosting(const ScoringPolicy& scoring, int document_number, double term_freq, double term_weight, double average_document_length) const noexcept;
+    // false, если какого-то слова фраз нет в индексе, и запросу не соответствует ни один документ
+    [[nodiscard]] bool ResolveQueryPhrases(const Query& query, QueryPhrases& phrases) const;
+    [[nodiscard]] bool ContainsPhrases(int document_number, const QueryPhrases& phrases) const;
+    // Top-K по запросу с фразами. Документ подходит, только если в нём есть все слова фраз, поэтому
+    // постинги этих слов пересекаются, а остальные плюс-слова только добавляют вклад. Релевантность
+    // считается до проверки позиций, и позиции читаются лишь у документов, которые вошли бы в top-K:
+    // таких немного, а проверка - самая дорогая часть, потому что позиции документа лежат вне постингов
+    template <typename DocumentPredicate, typename ScoringPolicy>
+    [[nodiscard]] std::vector<Document> FindTopPhraseDocuments(const std::vector<QueryTerms>& segment_terms, const QueryPhrases& phrases, DocumentPredicate& document_predicate, size_t result_count, const ScoringPolicy& scoring) const;
+    [[nodiscard]] bool IsProximityRanking(const Query& query) const noexcept;
+    void ApplyProximity(const Query& query, std::vector<Document>& documents) const;
+    // плюс-термы с весами в порядке запроса и минус-термы, разложенные по сегментам
+    [[nodiscard]] std::vector<QueryTerms> ResolveSegmentTerms(const std::vector<std::pair<TermDictionary::TermId, double>>& plus_terms, const std::vector<TermDictionary::TermId>& minus_terms) const;
+
+    // каждый сегмент делится на диапазоны id, которые обрабатываются независимо
+    template <typename ExecutionPolicy>
+    [[nodiscard]] std::vector<QueryTask> SplitQueryTasks(const std::vector<QueryTerms>& segment_terms) const;
+
+    // function(const IndexSegment&) для пишущегося и запечатанных сегментов
+    template <typename Function>
+    void ForEachSegment(Function function) const;
+
+    template <typename DocumentPredicate>
+    [[nodiscard]] bool IsDocumentAccepted(const DocumentPredicate& document_predicate, int document_id) const;
+
+    // ближайший к document_id документ, который может пройти предикат, или -1
+    template <typename DocumentPredicate>
+    [[nodiscard]] int FindNextCandidate(const DocumentPredicate& document_predicate, int document_id) const noexcept;
+
+    [[nodiscard]] TermDictionary::TermId FindIndexedTerm(std::string_view word) const;
+    [[nodiscard]] bool IsTermInDocument(TermDictionary::TermId term_id, int document_number) const;
+
+    // Постинги не трогаются: документ снимается из масок documents_ (надгробие), сегменту, где
+    // лежат его постинги, засчитывается удалённый документ, а сами постинги отбрасываются при слиянии
+    void MarkDocumentDeleted(int document_number);
+
+    void SealMutableSegment();
+    // сжимает нумерацию документов, если удалённые номера составляют большинство
+    void CompactDocumentNumbers();
+    void PollMerge();
+    void InstallMerge();
+    void ScheduleMerge();
+
+    [[nodiscard]] std::vector<std::pair<int, int>> SplitDocumentNumbers(size_t part_count) const;
+
+    [[nodiscard]] bool IsStopWord(std::string_view word) const;
+
+    [[nodiscard]] static bool CheckingForSpecialSymbols(const std::string_view& s);
+
+    [[nodiscard]] std::vector<std::string_view> SplitIntoWordsNoStop(const std::string_view& text) const;
+
+    // частоты слов документа, упорядоченные по слову; string_view указывают в text, в word_count -
+    // число нестоп-слов. Если word_positions задан, в него пишутся позиции каждого слова в том же порядке
+    [[nodiscard]] std::vector<std::pair<std::string_view, double>> ComputeWordFreqs(const std::string_view& text, uint32_t& word_count,
+        std::vector<std::vector<uint32_t>>* word_positions = nullptr) const;
+
+    void CheckNewDocumentId(int document_id) const;
+
+    [[nodiscard]] static int ComputeAverageRating(const std::vector<int>& ratings);
+
+    void ParseQuery(std::string_view text, Query& query) const;
+    // дописывает в words не больше max_prefix_expansion_ самых частых термов индекса с префиксом prefix;
+    // string_view указывают в словарь
+    void ExpandPrefix(std::string_view prefix, Query& query, std::vector<std::string_view>& words) const;
+    // дописывает в query.fuzzy_terms не больше MAX_FUZZY_EXPANSION ближайших к word термов индекса
+    void ExpandFuzzy(std::string_view word, Query& query) const;
+    // нечёткий терм запроса или nullptr, если term - слово самого запроса
+    [[nodiscard]] static const FuzzyTerm* FindFuzzyTerm(const Query& query, std::string_view term);
+
+    [[nodiscard]] static std::string MakeResultCacheKey(const Query& query, DocumentStatus status, size_t result_count);
+
+    [[nodiscard]] double ComputeWordInverseDocumentFreq(TermDictionary::TermId term_id) const;
+};
+
+template <typename DocumentPredicate, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate, size_t result_count) const {
+    return FindTopDocuments(policy, raw_query, document_predicate, result_count, TfIdfScoring{});
+}
+
+template <typename ScoringPolicy, typename DocumentPredicate, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const {
+    QueryBuffer query_buffer;
+    Query& query = query_buffer.Get();
+    ParseQuery(raw_query, query);
+    return FindTopDocumentsByQuery(policy, query, document_predicate, result_count, scoring);
+}
+
+template <typename ScoringPolicy, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status, size_t result_count, const ScoringPolicy& scoring) const {
+    if constexpr (std::is_same_v<ScoringPolicy, TfIdfScoring>) {
+        return FindTopDocuments(policy, raw_query, status, result_count);
+    }
+    else {
+        return FindTopDocuments(policy, raw_query, StatusFilter{ status }, result_count, scoring);
+    }
+}
+
+template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocumentsByQuery(ExecutionPolicy policy, const Query& query, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const {
+    const bool is_proximity_ranking = IsProximityRanking(query);
+    const size_t candidate_count = is_proximity_ranking && result_count <= std::numeric_limits<size_t>::max() / PROXIMITY_CANDIDATE_FACTOR
+        ? result_count * PROXIMITY_CANDIDATE_FACTOR : result_count;
+    std::vector<Document> documents;
+    if (query.phrase_ends.empty()) {
+        documents = FindTopDocumentsByTerms(policy, ResolveQueryTerms(query, scoring), document_predicate, candidate_count, scoring);
+    }
+    else {
+        QueryPhrases phrases;
+        if (!ResolveQueryPhrases(query, phrases)) {
+            return {};
+        }
+        documents = FindTopPhraseDocuments(ResolveQueryTerms(query, scoring), phrases, document_predicate, candidate_count, scoring);
+    }
+    if (is_proximity_ranking) {
+        ApplyProximity(query, documents);
+        SelectTopDocuments(policy, documents, result_count);
+    }
+    return documents;
+}
+
+template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocumentsByTerms(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const {
+    std::vector<Document> matched_documents;
+    if constexpr (HasScoreUpperBound<ScoringPolicy>::value) {
+        size_t plus_postings_count = 0;
+        for (const QueryTerms& query_terms : segment_terms) {
+            plus_postings_count += query_terms.plus_postings_count;
+        }
+        // если отбираем не меньше, чем всего постингов, отсекать нечего
+        matched_documents = plus_postings_count > result_count
+            ? FindTopDocumentsPruned(policy, segment_terms, document_predicate, result_count, scoring)
+            : FindAllDocuments(policy, segment_terms, document_predicate, scoring);
+    }
+    else {
+        // без границы вклада отсекать нечем
+        matched_documents = FindAllDocuments(policy, segment_terms, document_predicate, scoring);
+    }
+    SelectTopDocuments(policy, matched_documents, result_count);
+    return matched_documents;
+}
+
+template <typename ScoringPolicy>
+std::vector<SearchServer::QueryTerms> SearchServer::ResolveQueryTerms(const Query& query, const ScoringPolicy& scoring) const {
+    const CollectionStatistics collection = GetCollectionStatistics();
+    std::vector<std::pair<TermDictionary::TermId, double>> plus_terms;
+    for (const std::string_view word : query.plus_words) {
+        if (const TermDictionary::TermId term_id = FindIndexedTerm(word); term_id != TermDictionary::NO_TERM) {
+            const TermStatistics term{ document_freqs_[term_id], ComputeWordInverseDocumentFreq(term_id), word };
+            double term_weight = scoring.TermWeight(term, collection);
+            if (const FuzzyTerm* fuzzy = FindFuzzyTerm(query, word)) {
+                // редкая опечатка не должна весить больше самого слова
+                if (const TermDictionary::TermId word_id = FindIndexedTerm(fuzzy->word); word_id != TermDictionary::NO_TERM) {
+                    const TermStatistics word_term{ document_freqs_[word_id], ComputeWordInverseDocumentFreq(word_id), fuzzy->word };
+                    term_weight = std::min(term_weight, scoring.TermWeight(word_term, collection));
+                }
+                term_weight *= std::pow(FUZZY_WEIGHT_FACTOR, static_cast<double>(fuzzy->distance));
+            }
+            plus_terms.emplace_back(term_id, term_weight);
+        }
+    }
+    std::vector<TermDictionary::TermId> minus_terms;
+    for (const std::string_view word : query.minus_words) {
+        if (const TermDictionary::TermId term_id = FindIndexedTerm(word); term_id != TermDictionary::NO_TERM) {
+            minus_terms.push_back(term_id);
+        }
+    }
+    return ResolveSegmentTerms(plus_terms, minus_terms);
+}
+
+template <typename ScoringPolicy>
+double SearchServer::ScorePosting(const ScoringPolicy& scoring, int document_number, double term_freq, double term_weight, double average_document_length) const noexcept {
+    if constexpr (UsesDocumentLength<ScoringPolicy>::value) {
+        return scoring.Score(term_freq, term_weight, DocumentLength{ documents_.GetLength(document_number), average_document_length });
+    }
+    else {
+        return scoring.Score(term_freq, term_weight);
+    }
+}
+
+template <typename ExecutionPolicy>
+[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status, size_t result_count) const {
+    const StatusFilter status_predicate{ status };
+    if (!result_cache_) {
+        return FindTopDocuments(policy, raw_query, status_predicate, result_count);
+    }
+    QueryBuffer query_buffer;
+    Query& query = query_buffer.Get();
+    ParseQuery(raw_query, query);
+    std::string key = MakeResultCacheKey(query, status, result_count);
+    if (auto documents = result_cache_->Find(key, generation_)) {
+        return std::move(*documents);
+    }
+    auto documents = FindTopDocumentsByQuery(policy, query, status_predicate, result_count, TfIdfScoring{});
+    result_cache_->Insert(std::move(key), generation_, documents);
+    return documents;
+}
+
+template <typename DocumentPredicate, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    return FindTopDocuments(policy, raw_query, document_predicate, max_result_document_count_);
+}
+
+template <typename ExecutionPolicy>
+[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query, DocumentStatus status) const {
+    return FindTopDocuments(policy, raw_query, status, max_result_document_count_);
+}
+
+template <typename ExecutionPolicy>
+[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy policy, const std::string_view& raw_query) const {
+    return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
+}
+
+template <typename DocumentPredicate>
+[[nodiscard]] std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    return FindTopDocuments(std::execution::seq, raw_query, document_predicate);
+}
+
+template <typename ExecutionPolicy>
+void SearchServer::AddDocuments(ExecutionPolicy policy, const std::vector<NewDocument>& documents) {
+    PollMerge();
+    std::set<int> batch_ids;
+    for (const NewDocument& document : documents) {
+        CheckNewDocumentId(document.id);
+        if (!batch_ids.insert(document.id).second) {
+            throw std::invalid_argument(std::string{ "документ с таким id уже существует!" });
+        }
+    }
+
+    // частичный индекс каждого документа строится независимо; исключение из параллельного
+    // алгоритма привело бы к terminate, поэтому ошибки собираются и пробрасываются после
+    std::vector<std::vector<std::pair<std::string_view, double>>> document_word_freqs(documents.size());
+    std::vector<uint32_t> document_lengths(documents.size());
+    std::vector<std::vector<std::vector<uint32_t>>> document_word_positions(is_position_indexing_ ? documents.size() : 0);
+    std::vector<std::exception_ptr> errors(documents.size());
+    std::vector<size_t> indexes(documents.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::for_each(policy, indexes.begin(), indexes.end(), [this, &documents, &document_word_freqs, &document_lengths, &document_word_positions, &errors](size_t index) {
+        try {
+            document_word_freqs[index] = ComputeWordFreqs(documents[index].text, document_lengths[index],
+                is_position_indexing_ ? &document_word_positions[index] : nullptr);
+        }
+        catch (...) {
+            errors[index] = std::current_exception();
+        }
+    });
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    struct BatchPosting {
+        TermDictionary::TermId term_id;
+        Posting posting;
+    };
+    std::vector<BatchPosting> batch_postings;
+    size_t indexed_document_count = 0;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        indexed_document_count += document_word_freqs[i].empty() ? 0 : 1;
+        const int document_number = documents_.Add(documents[i].id, documents[i].status, ComputeAverageRating(documents[i].ratings), document_lengths[i]);
+        auto& word_freqs = document_word_freqs_.emplace_back();
+        std::vector<std::pair<TermDictionary::TermId, std::vector<uint32_t>>> term_positions;
+        for (size_t j = 0; j < document_word_freqs[i].size(); ++j) {
+            const auto& [word, term_freq] = document_word_freqs[i][j];
+            const TermDictionary::TermId term_id = terms_.Intern(word);
+            batch_postings.push_back({ term_id, { document_number, term_freq } });
+            word_freqs.emplace_hint(word_freqs.end(), terms_.GetTerm(term_id), term_freq);
+            if (is_position_indexing_) {
+                term_positions.emplace_back(term_id, std::move(document_word_positions[i][j]));
+            }
+        }
+        if (is_position_indexing_) {
+            positions_.Add(document_number, PositionIndex::Encode(std::move(term_positions)));
+        }
+    }
+
+    // постинги группируются по термам, и каждый постинг-лист сливается со своей группой
+    // один раз; разные термы не пересекаются, поэтому слияние идёт параллельно
+    std::sort(policy, batch_postings.begin(), batch_postings.end(), [](const BatchPosting& lhs, const BatchPosting& rhs) {
+        return lhs.term_id < rhs.term_id || (lhs.term_id == rhs.term_id && lhs.posting.document_id < rhs.posting.document_id);
+    });
+    std::vector<std::pair<size_t, size_t>> term_runs;
+    for (size_t first = 0; first < batch_postings.size();) {
+        size_t last = first + 1;
+        while (last < batch_postings.size() && batch_postings[last].term_id == batch_postings[first].term_id) {
+            ++last;
+        }
+        term_runs.emplace_back(first, last);
+        first = last;
+    }
+    mutable_segment_.Resize(terms_.size());
+    document_freqs_.resize(terms_.size(), 0);
+    inverse_document_freqs_.Reserve(terms_.size());
+    std::for_each(policy, term_runs.begin(), term_runs.end(), [this, &batch_postings](const std::pair<size_t, size_t>& term_run) {
+        const TermDictionary::TermId term_id = batch_postings[term_run.first].term_id;
+        std::vector<Posting> postings;
+        postings.reserve(term_run.second - term_run.first);
+        for (size_t i = term_run.first; i < term_run.second; ++i) {
+            postings.push_back(batch_postings[i].posting);
+        }
+        mutable_segment_.GetPostings(term_id).Merge(postings);
+        document_freqs_[term_id] += postings.size();
+        inverse_document_freqs_.SetDocumentFreq(term_id, document_freqs_[term_id]);
+    });
+    mutable_segment_.SetDocumentCount(mutable_segment_.GetDocumentCount() + indexed_document_count);
+    inverse_document_freqs_.SetDocumentCount(GetDocumentCount());
+    ++generation_;
+    if (mutable_segment_.GetDocumentCount() >= max_segment_document_count_) {
+        SealMutableSegment();
+    }
+}
+
+template<typename ExecutionPolicy>
+void SearchServer::RemoveDocument(ExecutionPolicy policy, int document_id) {
+    PollMerge();
+    if (const int document_number = documents_.FindNumber(document_id); document_number >= 0) {
+        const auto& word_freqs = document_word_freqs_[document_number];
+        // у каждого слова своя частота, поэтому параллельное обновление не пересекается
+        std::for_each(policy, word_freqs.begin(), word_freqs.end(),
+            [this](const std::pair<const std::string_view, double>& word_freq) {
+            const TermDictionary::TermId term_id = terms_.Find(word_freq.first);
+            inverse_document_freqs_.SetDocumentFreq(term_id, --document_freqs_[term_id]);
+        }
+        );
+        MarkDocumentDeleted(document_number);
+        inverse_document_freqs_.SetDocumentCount(GetDocumentCount());
+        ++generation_;
+        CompactDocumentNumbers();
+        ScheduleMerge();
+    }
+}
+
+template <typename ExecutionPolicy>
+void SearchServer::RemoveDocuments(ExecutionPolicy policy, const std::vector<int>& document_ids) {
+    PollMerge();
+    std::vector<int> document_numbers;
+    document_numbers.reserve(document_ids.size());
+    for (const int document_id : document_ids) {
+        if (const int document_number = documents_.FindNumber(document_id); document_number >= 0) {
+            document_numbers.push_back(document_number);
+        }
+    }
+    std::sort(document_numbers.begin(), document_numbers.end());
+    document_numbers.erase(std::unique(document_numbers.begin(), document_numbers.end()), document_numbers.end());
+    if (document_numbers.empty()) {
+        return;
+    }
+
+    // термы всех удаляемых документов собираются вместе, чтобы частота каждого уменьшилась один раз
+    std::vector<TermDictionary::TermId> term_ids;
+    for (const int document_number : document_numbers) {
+        for (const auto& [word, term_freq] : document_word_freqs_[document_number]) {
+            term_ids.push_back(terms_.Find(word));
+        }
+    }
+    std::sort(policy, term_ids.begin(), term_ids.end());
+    std::vector<std::pair<TermDictionary::TermId, size_t>> term_counts;
+    for (const TermDictionary::TermId term_id : term_ids) {
+        if (term_counts.empty() || term_counts.back().first != term_id) {
+            term_counts.emplace_back(term_id, 0);
+        }
+        ++term_counts.back().second;
+    }
+    std::for_each(policy, term_counts.begin(), term_counts.end(), [this](const std::pair<TermDictionary::TermId, size_t>& term_count) {
+        document_freqs_[term_count.first] -= term_count.second;
+        inverse_document_freqs_.SetDocumentFreq(term_count.first, document_freqs_[term_count.first]);
+    });
+
+    for (const int document_number : document_numbers) {
+        MarkDocumentDeleted(document_number);
+    }
+    inverse_document_freqs_.SetDocumentCount(GetDocumentCount());
+    ++generation_;
+    CompactDocumentNumbers();
+    ScheduleMerge();
+}
+
+template<typename ExecutionPolicy>
+[[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(ExecutionPolicy policy, std::string_view raw_query, int document_id) const {
+    const int document_number = documents_.FindNumber(document_id);
+    if (document_number < 0) {
+        throw std::out_of_range( "invalid document id "s);
+    }
+    QueryBuffer query_buffer;
+    Query& query = query_buffer.Get();
+    ParseQuery(raw_query, query);
+    const auto is_word_in_document = [this, document_number](std::string_view word) {
+        const TermDictionary::TermId term_id = FindIndexedTerm(word);
+        return term_id != TermDictionary::NO_TERM && IsTermInDocument(term_id, document_number);
+    };
+
+    if (std::any_of(policy, query.minus_words.begin(), query.minus_words.end(), is_word_in_document)) {
+        return { std::vector<std::string_view>{}, documents_.GetStatus(document_number) };
+    }
+    // документ без какой-то из фраз запросу не соответствует
+    if (!query.phrase_ends.empty()) {
+        QueryPhrases phrases;
+        if (!ResolveQueryPhrases(query, phrases) || !ContainsPhrases(document_number, phrases)) {
+            return { std::vector<std::string_view>{}, documents_.GetStatus(document_number) };
+        }
+    }
+
+    std::vector<std::string_view> matched_words(query.plus_words.size());
+    std::transform(policy, query.plus_words.begin(), query.plus_words.end(), matched_words.begin(),
+        [this, &is_word_in_document](std::string_view word) {
+        return is_word_in_document(word) ? terms_.GetTerm(terms_.Find(word)) : std::string_view{};
+    });
+    matched_words.erase(std::remove(matched_words.begin(), matched_words.end(), std::string_view{}), matched_words.end());
+
+    return { matched_words, documents_.GetStatus(document_number) };
+}
+
+template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindAllDocuments(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, const ScoringPolicy& scoring) const {
+    // каждая задача копит релевантность только своего диапазона id своего сегмента, поэтому блокировки не нужны
+    const auto tasks = SplitQueryTasks<ExecutionPolicy>(segment_terms);
+    if (tasks.empty()) {
+        return {};
+    }
+    std::vector<std::vector<Document>> range_documents(tasks.size());
+    const double average_document_length = documents_.GetAverageLength();
+
+    std::transform(policy, tasks.begin(), tasks.end(), range_documents.begin(),
+        [this, &document_predicate, &scoring, average_document_length](const QueryTask& task) {
+        const auto& [query_terms, id_range] = task;
+        // постинги сегмента целиком - оценка сверху для диапазона
+        size_t postings_count = query_terms->plus_postings_count;
+        for (const PostingList* postings : query_terms->minus_postings) {
+            postings_count += postings->size();
+        }
+        RelevanceAccumulator accumulator(id_range.first, id_range.second, postings_count);
+        for (const PostingList* postings : query_terms->minus_postings) {
+            for (PostingCursor cursor(*postings, id_range.first, id_range.second); !cursor.IsEnd(); cursor.Next()) {
+                accumulator.Exclude(cursor->document_id);
+            }
+        }
+        const auto document_filter = [this, &document_predicate](int document_id) {
+            return IsDocumentAccepted(document_predicate, document_id);
+        };
+        for (const auto& [postings, term_weight] : query_terms->plus_terms) {
+            for (PostingCursor cursor(*postings, id_range.first, id_range.second); !cursor.IsEnd();) {
+                const int candidate_id = FindNextCandidate(document_predicate, cursor->document_id);
+                if (candidate_id != cursor->document_id) {
+                    if (candidate_id < 0) {
+                        break;
+                    }
+                    cursor.Seek(candidate_id);
+                    continue;
+                }
+                accumulator.Add(cursor->document_id, ScorePosting(scoring, cursor->document_id, cursor->term_freq, term_weight, average_document_length), document_filter);
+                cursor.Next();
+            }
+        }
+
+        std::vector<Document> matched_documents;
+        for (const auto& [document_id, relevance] : accumulator.Collect()) {
+            matched_documents.push_back({ documents_.GetDocumentId(document_id), relevance, documents_.GetRating(document_id) });
+        }
+        return matched_documents;
+    });
+
+    if (range_documents.size() == 1) {
+        return std::move(range_documents.front());
+    }
+    std::vector<Document> matched_documents;
+    for (auto& documents : range_documents) {
+        matched_documents.insert(matched_documents.end(), documents.begin(), documents.end());
+    }
+    return matched_documents;
+}
+
+template <typename DocumentPredicate, typename ScoringPolicy, typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopDocumentsPruned(ExecutionPolicy policy, const std::vector<QueryTerms>& segment_terms, DocumentPredicate document_predicate, size_t result_count, const ScoringPolicy& scoring) const {
+    // у каждой задачи своя куча лучших; кандидаты затем отбираются SelectTopDocuments
+    const auto tasks = SplitQueryTasks<ExecutionPolicy>(segment_terms);
+    if (tasks.empty() || result_count == 0) {
+        return {};
+    }
+    std::vector<std::vector<Document>> range_documents(tasks.size());
+
+    std::transform(policy, tasks.begin(), tasks.end(), range_documents.begin(),
+        [this, &document_predicate, result_count, &scoring](const QueryTask& task) {
+        return FindTopDocumentsMaxScore(*task.query_terms, document_predicate, task.id_range, result_count, scoring);
+    });
+
+    if (range_documents.size() == 1) {
+        return std::move(range_documents.front());
+    }
+    std::vector<Document> matched_documents;
+    for (auto& documents : range_documents) {
+        matched_documents.insert(matched_documents.end(), documents.begin(), documents.end());
+    }
+    return matched_documents;
+}
+
+template <typename ExecutionPolicy>
+std::vector<SearchServer::QueryTask> SearchServer::SplitQueryTasks(const std::vector<QueryTerms>& segment_terms) const {
+    size_t plus_postings_count = 0;
+    for (const QueryTerms& query_terms : segment_terms) {
+        plus_postings_count += query_terms.plus_postings_count;
+    }
+    const size_t part_count = IsSequencedPolicy<ExecutionPolicy>() ? 1 : plus_postings_count / MIN_POSTINGS_PER_TASK + 1;
+    const auto id_ranges = SplitDocumentNumbers(part_count);
+
+    std::vector<QueryTask> tasks;
+    for (const QueryTerms& query_terms : segment_terms) {
+        for (const auto& id_range : id_ranges) {
+            tasks.push_back({ &query_terms, id_range });
+        }
+    }
+    return tasks;
+}
+
+template <typename Function>
+void SearchServer::ForEachSegment(Function function) const {
+    function(mutable_segment_);
+    for (const SealedSegment& sealed : sealed_segments_) {
+        function(*sealed.segment);
+    }
+}
+
+// MaxScore: термы упорядочены по верхней границе вклада (для TF-IDF это max_tf * idf). Термы, суммарная граница
+// которых не дотягивает до порога текущего top-K, "несущественные": документ, встречающийся
+// только в них, пропускается, а их постинги проверяются лишь для кандидатов из существенных.
+// Релевантность кандидата складывается в порядке слов запроса, как в FindAllDocuments,
+// поэтому результат побитово совпадает с полным перебором.
+template <typename DocumentPredicate, typename ScoringPolicy>
+std::vector<Document> SearchServer::FindTopDocumentsMaxScore(const QueryTerms& query_terms, DocumentPredicate& document_predicate, std::pair<int, int> id_range, size_t result_count, const ScoringPolicy& scoring) const {
+    struct TermCursor {
+        PostingCursor postings;
+        double term_weight;
+        double upper_bound;
+        size_t query_index;
+    };
+
+    const CollectionStatistics collection = GetCollectionStatistics();
+    const double average_document_length = collection.average_document_length;
+    std::vector<TermCursor> cursors;
+    for (size_t i = 0; i < query_terms.plus_terms.size(); ++i) {
+        const auto& [postings, term_weight] = query_terms.plus_terms[i];
+        PostingCursor cursor(*postings, id_range.first, id_range.second);
+        if (!cursor.IsEnd()) {
+            cursors.push_back({ std::move(cursor), term_weight, scoring.UpperBound(postings->GetMaxTermFreq(), term_weight, collection), i });
+        }
+    }
+    std::vector<PostingCursor> minus_cursors;
+    for (const PostingList* postings : query_terms.minus_postings) {
+        minus_cursors.emplace_back(*postings, id_range.first, id_range.second);
+    }
+    std::stable_sort(cursors.begin(), cursors.end(), [](const TermCursor& lhs, const TermCursor& rhs) {
+        return lhs.upper_bound < rhs.upper_bound;
+    });
+    std::vector<double> cumulative_bounds(cursors.size());
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        cumulative_bounds[i] = cursors[i].upper_bound + (i > 0 ? cumulative_bounds[i - 1] : 0.0);
+    }
+
+    // документ войдёт в top-K, только если его релевантность больше порога: при разнице меньше 1e-6
+    // решает рейтинг, поэтому порог занижен на 1e-6 и ещё немного на погрешность суммирования
+    constexpr double TIE_MARGIN = 1e-6 + 1e-9;
+    TopDocuments top_documents(result_count);
+    double threshold = -std::numeric_limits<double>::infinity();
+    size_t first_essential = 0;
+    std::vector<double> contributions(query_terms.plus_terms.size(), 0.0);
+
+    while (first_essential < cursors.size()) {
+        int document_id = std::numeric_limits<int>::max();
+        bool has_candidate = false;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            if (!cursors[i].postings.IsEnd()) {
+                document_id = std::min(document_id, cursors[i].postings->document_id);
+                has_candidate = true;
+            }
+        }
+        if (!has_candidate) {
+            break;
+        }
+        // документы, не проходящие фильтр статуса, пропускаются пачкой
+        if (const int candidate_id = FindNextCandidate(document_predicate, document_id); candidate_id != document_id) {
+            if (candidate_id < 0) {
+                break;
+            }
+            for (size_t i = first_essential; i < cursors.size(); ++i) {
+                cursors[i].postings.Seek(candidate_id);
+            }
+            continue;
+        }
+
+        std::fill(contributions.begin(), contributions.end(), 0.0);
+        double score = 0.0;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            TermCursor& cursor = cursors[i];
+            if (!cursor.postings.IsEnd() && cursor.postings->document_id == document_id) {
+                contributions[cursor.query_index] = ScorePosting(scoring, document_id, cursor.postings->term_freq, cursor.term_weight, average_document_length);
+                score += contributions[cursor.query_index];
+                cursor.postings.Next();
+            }
+        }
+        bool is_pruned = false;
+        for (size_t i = first_essential; i-- > 0;) {
+            if (score + cumulative_bounds[i] <= threshold) {
+                is_pruned = true;
+                break;
+            }
+            TermCursor& cursor = cursors[i];
+            cursor.postings.Seek(document_id);
+            if (!cursor.postings.IsEnd() && cursor.postings->document_id == document_id) {
+                contributions[cursor.query_index] = ScorePosting(scoring, document_id, cursor.postings->term_freq, cursor.term_weight, average_document_length);
+                score += contributions[cursor.query_index];
+            }
+        }
+        if (is_pruned || score <= threshold) {
+            continue;
+        }
+
+        bool is_excluded = false;
+        for (PostingCursor& cursor : minus_cursors) {
+            cursor.Seek(document_id);
+            if (!cursor.IsEnd() && cursor->document_id == document_id) {
+                is_excluded = true;
+                break;
+            }
+        }
+        if (is_excluded) {
+            continue;
+        }
+        if (!IsDocumentAccepted(document_predicate, document_id)) {
+            continue;
+        }
+
+        double relevance = 0.0;
+        for (const double contribution : contributions) {
+            relevance += contribution;
+        }
+        top_documents.Push({ documents_.GetDocumentId(document_id), relevance, documents_.GetRating(document_id) });
+        if (top_documents.IsFull()) {
+            threshold = top_documents.GetWorst().relevance - TIE_MARGIN;
+            while (first_essential < cursors.size() && cumulative_bounds[first_essential] <= threshold) {
+                ++first_essential;
+            }
+        }
+    }
+    return top_documents.Extract();
+}
+
+template <typename DocumentPredicate, typename ScoringPolicy>
+std::vector<Document> SearchServer::FindTopPhraseDocuments(const std::vector<QueryTerms>& segment_terms, const QueryPhrases& phrases, DocumentPredicate& document_predicate, size_t result_count, const ScoringPolicy& scoring) const {
+    // постинги слов фраз во всех сегментах: по ним плюс-термы сегмента делятся на обязательные и прочие
+    std::vector<TermDictionary::TermId> phrase_term_ids;
+    for (const PositionIndex::PhraseTerm& phrase_term : phrases.phrase_terms) {
+        phrase_term_ids.push_back(phrase_term.term_id);
+    }
+    std::sort(phrase_term_ids.begin(), phrase_term_ids.end());
+    phrase_term_ids.erase(std::unique(phrase_term_ids.begin(), phrase_term_ids.end()), phrase_term_ids.end());
+    std::vector<const PostingList*> phrase_postings;
+    std::vector<size_t> phrase_term_sizes(phrase_term_ids.size(), 0);
+    ForEachSegment([&phrase_term_ids, &phrase_postings, &phrase_term_sizes](const IndexSegment& segment) {
+        for (size_t i = 0; i < phrase_term_ids.size(); ++i) {
+            if (const PostingList* postings = segment.FindPostings(phrase_term_ids[i])) {
+                phrase_postings.push_back(postings);
+                phrase_term_sizes[i] += postings->size();
+            }
+        }
+    });
+    std::sort(phrase_postings.begin(), phrase_postings.end());
+
+    // кандидатов не больше, чем постингов у самого редкого слова фраз, а K может быть сколь угодно большим
+    size_t candidate_count = result_count;
+    for (const size_t term_size : phrase_term_sizes) {
+        candidate_count = std::min(candidate_count, term_size);
+    }
+    if (candidate_count == 0) {
+        return {};
+    }
+    const double average_document_length = GetCollectionStatistics().average_document_length;
+    TopDocuments top_documents(candidate_count);
+    for (const QueryTerms& query_terms : segment_terms) {
+        std::vector<PostingCursor> cursors;
+        std::vector<size_t> required;
+        for (size_t i = 0; i < query_terms.plus_terms.size(); ++i) {
+            const PostingList* postings = query_terms.plus_terms[i].postings;
+            cursors.emplace_back(*postings);
+            if (std::binary_search(phrase_postings.begin(), phrase_postings.end(), postings)) {
+                required.push_back(i);
+            }
+        }
+        // без какого-то слова фраз в сегменте нет подходящих документов
+        if (required.size() < phrase_term_ids.size()) {
+            continue;
+        }
+        // пересечение ведёт самый короткий список
+        std::sort(required.begin(), required.end(), [&query_terms](size_t lhs, size_t rhs) {
+            return query_terms.plus_terms[lhs].postings->size() < query_terms.plus_terms[rhs].postings->size();
+        });
+        std::vector<PostingCursor> minus_cursors;
+        for (const PostingList* postings : query_terms.minus_postings) {
+            minus_cursors.emplace_back(*postings);
+        }
+
+        PostingCursor& lead = cursors[required.front()];
+        while (!lead.IsEnd()) {
+            const int document_id = lead->document_id;
+            if (const int candidate_id = FindNextCandidate(document_predicate, document_id); candidate_id != document_id) {
+                if (candidate_id < 0) {
+                    break;
+                }
+                lead.Seek(candidate_id);
+                continue;
+            }
+            int next_id = document_id;
+            for (size_t i = 1; i < required.size() && next_id == document_id; ++i) {
+                PostingCursor& cursor = cursors[required[i]];
+                cursor.Seek(document_id);
+                next_id = cursor.IsEnd() ? -1 : cursor->document_id;
+            }
+            if (next_id < 0) {
+                break;
+            }
+            if (next_id != document_id) {
+                lead.Seek(next_id);
+                continue;
+            }
+
+            const bool is_excluded = std::any_of(minus_cursors.begin(), minus_cursors.end(), [document_id](PostingCursor& cursor) {
+                cursor.Seek(document_id);
+                return !cursor.IsEnd() && cursor->document_id == document_id;
+            });
+            if (!is_excluded && IsDocumentAccepted(document_predicate, document_id)) {
+                // вклады складываются в порядке запроса, как в FindTopDocumentsMaxScore, поэтому
+                // релевантность та же, что у запроса без кавычек
+                double relevance = 0.0;
+                for (size_t i = 0; i < cursors.size(); ++i) {
+                    PostingCursor& cursor = cursors[i];
+                    cursor.Seek(document_id);
+                    if (!cursor.IsEnd() && cursor->document_id == document_id) {
+                        relevance += ScorePosting(scoring, document_id, cursor->term_freq, query_terms.plus_terms[i].term_weight, average_document_length);
+                    }
+                }
+                const Document document{ documents_.GetDocumentId(document_id), relevance, documents_.GetRating(document_id) };
+                if ((!top_documents.IsFull() || IsMoreRelevant(document, top_documents.GetWorst())) && ContainsPhrases(document_id, phrases)) {
+                    top_documents.Push(document);
+                }
+            }
+            lead.Next();
+        }
+    }
+    return top_documents.Extract();
+}
+
+template <typename DocumentPredicate>
+bool SearchServer::IsDocumentAccepted(const DocumentPredicate& document_predicate, int document_id) const {
+    if constexpr (std::is_same_v<DocumentPredicate, StatusFilter>) {
+        return documents_.HasStatus(document_id, document_predicate.status);
+    }
+    else {
+        return documents_.IsAlive(document_id)
+            && document_predicate(documents_.GetDocumentId(document_id), documents_.GetStatus(document_id), documents_.GetRating(document_id));
+    }
+}
+
+template <typename DocumentPredicate>
+int SearchServer::FindNextCandidate(const DocumentPredicate& document_predicate, int document_id) const noexcept {
+    if constexpr (std::is_same_v<DocumentPredicate, StatusFilter>) {
+        return documents_.FindNext(document_predicate.status, document_id);
+    }
+    else {
+        return documents_.FindNextAlive(document_id);
+    }
+}
+
 void PrintMatchDocumentResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status);
\ No newline at end of file
@@ -1,338 +1,1693 @@
-#include "search_server_tests.h"
-
-#include <execution>
-
-void AddDocumentTest() {                 
-    SearchServer server(std::string{ "" });
-    const int doc_id = 42;
-    server.AddDocument(doc_id, std::string{ "cat in the city" }, DocumentStatus::ACTUAL, { 1, 2, 3 });
-    const auto found_docs1 = server.FindTopDocuments(std::string{ "cat" });
-    const auto found_docs2 = server.FindTopDocuments(std::string{ "in" });
-    const auto found_docs3 = server.FindTopDocuments(std::string{ "the" });
-    const auto found_docs4 = server.FindTopDocuments(std::string{ "city" });
-
-    ASSERT_EQUAL(found_docs1.size(), 1u);
-    ASSERT_EQUAL(found_docs1[0].id, doc_id);
-    ASSERT_EQUAL(found_docs2.size(), 1u);
-    ASSERT_EQUAL(found_docs2[0].id, doc_id);
-    ASSERT_EQUAL(found_docs3.size(), 1u);
-    ASSERT_EQUAL(found_docs3[0].id, doc_id);
-    ASSERT_EQUAL(found_docs4.size(), 1u);
-    ASSERT_EQUAL(found_docs4[0].id, doc_id);
-}
-
-void Test_GetWordFrequencies() {
-    SearchServer search_server(std::string{ "and with" });
-   
-    search_server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
-    search_server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
-
-    auto word_freq = search_server.GetWordFrequencies(1);
-
-    ASSERT_EQUAL(word_freq.size(), 4);
-    ASSERT_EQUAL(word_freq.at(std::string{ "funny" }), 0.25);
-    ASSERT_EQUAL(word_freq.at(std::string{ "pet" }), 0.25);
-    ASSERT_EQUAL(word_freq.at(std::string{ "nasty" }), 0.25);
-    ASSERT_EQUAL(word_freq.at(std::string{ "rat" }), 0.25);
-}
-
-void Test_RemoveDocument() {
-    SearchServer search_server(std::string{ "and with" });
-
-    search_server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
-    search_server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
-    search_server.AddDocument(3, std::string{ "funny pet and not very nasty rat" }, DocumentStatus::ACTUAL, { 1, 2 });
-    search_server.AddDocument(4, std::string{ "nasty rat with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
-
-    search_server.RemoveDocument(2);
-    search_server.RemoveDocument(1);
-
-    auto iter = search_server.begin();
-
-    ASSERT_EQUAL(search_server.GetDocumentCount(), 2);
-    ASSERT_EQUAL(*iter, 3);
-    ASSERT_EQUAL(*(++iter), 4);
-}
-
-
-void Test_ExcludeStopWords_FromAddedDocumentContent() {
-    const int doc_id = 42;
-    const std::string content = std::string{ "cat in the city" };
-    const std::vector<int> ratings = { 1, 2, 3 };
-    {
-        SearchServer server(std::string{ "in the" });
-        server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-
-        ASSERT(server.FindTopDocuments(std::string{ "in" }).empty());
-    }
-}
-
-void Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(const std::string& query) {
-    SearchServer server(std::string{ "" });
-    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-
-    const auto found_docs = server.FindTopDocuments(query);
-
-    ASSERT_EQUAL(found_docs.size(), 1u);
-    ASSERT_EQUAL(found_docs[0].id, 42);
-}
-
-void TestExcludedMinusWords_WithOneDocument_ResultEmpty() {
-    SearchServer server(std::string{ "" });
-    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-
-    const auto found_docs = server.FindTopDocuments(std::string{ "cat -city" });
-
-    ASSERT(found_docs.empty());
-}
-
-void TestExcludedMinusWords_FromTwoDocuments_ResultEmpty() {
-    SearchServer server(std::string{ "" });
-    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(104, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
-
-    const auto found_docs = server.FindTopDocuments(std::string{ "in -in" });
-
-    ASSERT(found_docs.empty());
-}
-
-void TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(const std::string& query, int etalonID) {
-    SearchServer server(std::string{ "" });
-    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(104, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
-
-    const auto found_docs = server.FindTopDocuments(query);
-
-    ASSERT_EQUAL(found_docs.size(), 1u);
-    ASSERT_EQUAL(found_docs[0].id, etalonID);
-}
-
-void TestExcludedMinusWords_FromTwoDocuments_ResultTwoDocuments() {
-    const int doc_id = 42, doc_id1 = 104;
-    SearchServer server(std::string{ "" });
-    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(doc_id1, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
-
-    const auto found_docs = server.FindTopDocuments(std::string{ "in" });
-
-    ASSERT_EQUAL(found_docs.size(), 2u);
-    ASSERT_EQUAL(found_docs[0].id, doc_id);
-    ASSERT_EQUAL(found_docs[1].id, doc_id1);
-}
-
-void Test_GetDocumentCount_ResultEmpty() {
-    const int doc_id = 42, doc_id1 = 104;
-    SearchServer server(std::string{ "" });
-    
-    int document_count = server.GetDocumentCount();
-
-    ASSERT_EQUAL(document_count, 0);
-}
-
-void Test_GetDocumentCount_ResultThreeDocuments() {
-    const int doc_id = 42, doc_id1 = 104, doc_id2 = 210;
-    SearchServer server(std::string{ "" });
-    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(doc_id1, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(doc_id2, std::string{ "dog life is best life" }, DocumentStatus::ACTUAL, { 1 });
-
-    int document_count = server.GetDocumentCount();
-
-    ASSERT_EQUAL(document_count, 3);
-}
-
-void TestMatchDocument() {
-    const int doc_id = 42;
-    SearchServer server(std::string{ "" });
-    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    const std::string word1 = std::string{ "cat" };
-    const std::string word2 = std::string{ "in" };
-    const std::string word3 = std::string{ "cool" };
-    const std::string word4 = std::string{ "city" };
-
-    {
-        const auto& [find_words, status] = server.MatchDocument(std::string{ "cat in cool city" }, doc_id);
-
-        ASSERT(status == DocumentStatus::ACTUAL);
-        ASSERT(count(find_words.begin(), find_words.end(), word1));
-        ASSERT(count(find_words.begin(), find_words.end(), word2));
-        ASSERT(count(find_words.begin(), find_words.end(), word3));
-        ASSERT(count(find_words.begin(), find_words.end(), word4));
-        ASSERT_EQUAL(find_words.size(), 4u);
-    }
-    {
-        const auto& [find_words, status] = server.MatchDocument(std::string{ "cat bad giy city" }, doc_id);
-
-        ASSERT(status == DocumentStatus::ACTUAL);
-        ASSERT(count(find_words.begin(), find_words.end(), word1));
-        ASSERT(count(find_words.begin(), find_words.end(), word4));
-        ASSERT_EQUAL(find_words.size(), 2u);
-    }
-
-    {
-        const auto& [find_words, status] = server.MatchDocument(std::string{ "dog life is best life" }, doc_id);
-
-        ASSERT(status == DocumentStatus::ACTUAL);
-        ASSERT(find_words.empty());
-    }
-    {
-        const auto& [find_words, status] = server.MatchDocument(std::string{ "" }, doc_id);
-
-        ASSERT(status == DocumentStatus::ACTUAL);
-        ASSERT(find_words.empty());
-    }
-}
-
-SearchServer reating_Filled_Object(int id, int id1, int id2, int id3, int id4) {
-    SearchServer server(std::string{ "" });
-    server.AddDocument(id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(id1, std::string{ "dog in cool world" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(id2, std::string{ "throw duck in a river" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(id3, std::string{ "i am so good dog" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(id4, std::string{ "king of the hill" }, DocumentStatus::ACTUAL, { 1 });
-    return server;
-}
-
-void Test_FindTopDocuments_SortByRelevance() {
-    const int doc_id = 42;
-    const int doc_id1 = 104;
-    const int doc_id2 = 950;
-    const int doc_id3 = 272;
-    const int doc_id4 = 1080;
-    const int doc_id5 = 228;
-    SearchServer server = reating_Filled_Object(doc_id, doc_id1, doc_id2, doc_id3, doc_id4);  
-
-    {                                                   
-        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog" });
-
-        ASSERT_EQUAL(found_docs.size(), 3u);
-        ASSERT_EQUAL(found_docs[0].id, doc_id);
-        ASSERT_EQUAL(found_docs[1].id, doc_id1);
-        ASSERT_EQUAL(found_docs[2].id, doc_id3);
-    }
-
-    {
-        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog duck good hill" });
-
-        ASSERT_EQUAL(found_docs.size(), 5u);
-        ASSERT_EQUAL(found_docs[0].id, doc_id3);
-        ASSERT_EQUAL(found_docs[1].id, doc_id);
-        ASSERT_EQUAL(found_docs[2].id, doc_id4);
-        ASSERT_EQUAL(found_docs[3].id, doc_id2);
-        ASSERT_EQUAL(found_docs[4].id, doc_id1);
-    }
-
-    {
-        server.AddDocument(doc_id5, std::string{ "my room is good anouth" }, DocumentStatus::ACTUAL, { 1 });
-        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog duck good hill" });
-
-        ASSERT_EQUAL(found_docs.size(), 5u);
-        ASSERT_EQUAL(found_docs[0].id, doc_id);
-        ASSERT_EQUAL(found_docs[1].id, doc_id4);
-        ASSERT_EQUAL(found_docs[2].id, doc_id3);
-        ASSERT_EQUAL(found_docs[3].id, doc_id2);
-        ASSERT_EQUAL(found_docs[4].id, doc_id1);
-    }
-}
-
-void Test_CalculateRating() {
-    const std::string content = std::string{ "cat in cool city" };
-    const int arithmetic_mean_document_1 = 2;
-    const int arithmetic_mean_document_2 = 5;
-    const int arithmetic_mean_document_3 = -3;
-    const int arithmetic_mean_document_4 = 1;
-    SearchServer server(std::string{ "" });
-    server.AddDocument(1, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
-    server.AddDocument(2, content, DocumentStatus::ACTUAL, { 4, 28, -16 });
-    server.AddDocument(3, content, DocumentStatus::ACTUAL, { 4, -16, 3 });
-    server.AddDocument(4, content, DocumentStatus::ACTUAL, { 1, 3, 1 });
-    auto found_docs = server.FindTopDocuments(std::string{ "cat" });
-    std::sort(std::execution::par, found_docs.begin(), found_docs.end(), [](const Document& lhs, const Document& rhs) {
-        return lhs.id < rhs.id;
-    });
-
-    ASSERT_EQUAL(found_docs.size(), 4u);
-    ASSERT_EQUAL(found_docs[0].rating, arithmetic_mean_document_1);
-    ASSERT_EQUAL(found_docs[1].rating, arithmetic_mean_document_2);
-    ASSERT_EQUAL(found_docs[2].rating, arithmetic_mean_document_3);
-    ASSERT_EQUAL(found_docs[3].rating, arithmetic_mean_document_4);
-}
-
-void Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus status, int etalonId)
-{
-    const int doc_id = 42;
-    const int doc_id1 = 104;
-    const int doc_id2 = 950;
-    const int doc_id3 = 272;
-    const std::string content = std::string{ "cat in cool city" };
-    const std::vector ratings = { 1 };
-    SearchServer server(std::string{ "" });
-    server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
-    server.AddDocument(doc_id1, content, DocumentStatus::REMOVED, ratings);
-    server.AddDocument(doc_id2, content, DocumentStatus::BANNED, ratings);
-    server.AddDocument(doc_id3, content, DocumentStatus::IRRELEVANT, ratings);
-
-    const auto found_docs = server.FindTopDocuments(std::execution::seq, std::string{ "cat" }, status);
-
-    ASSERT_EQUAL(found_docs.size(), 1u);
-    ASSERT_EQUAL(found_docs[0].id, etalonId);
-}
-
-void Test_RelevanceCalculation() {
-    SearchServer server(std::string{ "" });
-    const double relevance_doc_1_and_2 = 0.135155;
-    const double relevance_doc_3 = 0.366204;
-    server.AddDocument(1, std::string{ "cat and dog" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(2, std::string{ "cat and cow" }, DocumentStatus::ACTUAL, { 1 });
-    server.AddDocument(3, std::string{ "city" }, DocumentStatus::ACTUAL, { 1 });
-
-    {
-        auto foundDocs = server.FindTopDocuments(std::string{ "cat" });
-        std::sort(std::execution::par, foundDocs.begin(), foundDocs.end(),
-            [](const Document& lhs, const Document& rhs) {
-            return lhs.id < rhs.id;
-        });
-
-        ASSERT_EQUAL(foundDocs.size(), 2u);
-        ASSERT_EQUAL(foundDocs[0].relevance, relevance_doc_1_and_2);  
-        ASSERT_EQUAL(foundDocs[1].relevance, relevance_doc_1_and_2);
-    }
-    {
-        auto foundDocs = server.FindTopDocuments(std::string{ "dog" });
-
-        ASSERT_EQUAL(foundDocs.size(), 1u);
-        ASSERT_EQUAL(foundDocs[0].relevance, relevance_doc_3);
-    }
-}
-
-void TestSearchServer() {
-    RUN_TEST(Test_ExcludeStopWords_FromAddedDocumentContent);
-    RUN_TEST(AddDocumentTest);
-    RUN_TEST(Test_GetWordFrequencies);
-    RUN_TEST(Test_RemoveDocument);
-    RUN_TEST(TestExcludedMinusWords_WithOneDocument_ResultEmpty);
-    RUN_TEST_WITH_ARG(Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(std::string{ "cat" }));
-    RUN_TEST_WITH_ARG(Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(std::string{ "cat -dog" }));
-    RUN_TEST_WITH_ARG(TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(std::string{ "in -world" }, 42));
-    RUN_TEST_WITH_ARG(TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(std::string{ "in -city" }, 104));
-    RUN_TEST(TestExcludedMinusWords_FromTwoDocuments_ResultTwoDocuments);
-    RUN_TEST(TestExcludedMinusWords_FromTwoDocuments_ResultEmpty);
-    RUN_TEST(Test_GetDocumentCount_ResultEmpty);
-    RUN_TEST(Test_GetDocumentCount_ResultThreeDocuments);
-    RUN_TEST(TestMatchDocument);
-    RUN_TEST(Test_FindTopDocuments_SortByRelevance);
-    RUN_TEST(Test_CalculateRating);
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::ACTUAL, 42));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::BANNED, 950));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::IRRELEVANT, 272));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::REMOVED, 104));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_EmptySearchServer_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }, std::string{ "cat dog" }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_EmptySearchServer_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }, std::string{ "" }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return status != DocumentStatus::ACTUAL; }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return id != 42; }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return rating <= 5; }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return status == DocumentStatus::ACTUAL; }));
-    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return id == 42;  }));
-    RUN_TEST(Test_RelevanceCalculation);
+#include "search_server_tests.h"
+
+#include <atomic>
+#include <cmath>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+void AddDocumentTest() {                 
+    SearchServer server(std::string{ "" });
+    const int doc_id = 42;
+    server.AddDocument(doc_id, std::string{ "cat in the city" }, DocumentStatus::ACTUAL, { 1, 2, 3 });
+    const auto found_docs1 = server.FindTopDocuments(std::string{ "cat" });
+    const auto found_docs2 = server.FindTopDocuments(std::string{ "in" });
+    const auto found_docs3 = server.FindTopDocuments(std::string{ "the" });
+    const auto found_docs4 = server.FindTopDocuments(std::string{ "city" });
+
+    ASSERT_EQUAL(found_docs1.size(), 1u);
+    ASSERT_EQUAL(found_docs1[0].id, doc_id);
+    ASSERT_EQUAL(found_docs2.size(), 1u);
+    ASSERT_EQUAL(found_docs2[0].id, doc_id);
+    ASSERT_EQUAL(found_docs3.size(), 1u);
+    ASSERT_EQUAL(found_docs3[0].id, doc_id);
+    ASSERT_EQUAL(found_docs4.size(), 1u);
+    ASSERT_EQUAL(found_docs4[0].id, doc_id);
+}
+
+void Test_GetWordFrequencies() {
+    SearchServer search_server(std::string{ "and with" });
+   
+    search_server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
+    search_server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
+
+    auto word_freq = search_server.GetWordFrequencies(1);
+
+    ASSERT_EQUAL(word_freq.size(), 4);
+    ASSERT_EQUAL(word_freq.at(std::string{ "funny" }), 0.25);
+    ASSERT_EQUAL(word_freq.at(std::string{ "pet" }), 0.25);
+    ASSERT_EQUAL(word_freq.at(std::string{ "nasty" }), 0.25);
+    ASSERT_EQUAL(word_freq.at(std::string{ "rat" }), 0.25);
+}
+
+void Test_RemoveDocument() {
+    SearchServer search_server(std::string{ "and with" });
+
+    search_server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
+    search_server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
+    search_server.AddDocument(3, std::string{ "funny pet and not very nasty rat" }, DocumentStatus::ACTUAL, { 1, 2 });
+    search_server.AddDocument(4, std::string{ "nasty rat with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
+
+    search_server.RemoveDocument(2);
+    search_server.RemoveDocument(1);
+
+    auto iter = search_server.begin();
+
+    ASSERT_EQUAL(search_server.GetDocumentCount(), 2);
+    ASSERT_EQUAL(*iter, 3);
+    ASSERT_EQUAL(*(++iter), 4);
+}
+
+void Test_RemoveDocument_ExcludedFromSearch() {
+    SearchServer search_server(std::string{ "and with" });
+
+    search_server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
+    search_server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
+
+    search_server.RemoveDocument(1);
+
+    ASSERT(search_server.FindTopDocuments(std::string{ "rat" }).empty());
+    const auto found_docs = search_server.FindTopDocuments(std::string{ "funny curly" });
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, 2);
+
+    search_server.AddDocument(1, std::string{ "nasty rat" }, DocumentStatus::ACTUAL, { 1 });
+    ASSERT_EQUAL(search_server.FindTopDocuments(std::string{ "rat" }).size(), 1u);
+    ASSERT_EQUAL(search_server.GetWordFrequencies(1).at(std::string{ "rat" }), 0.5);
+}
+
+
+void Test_ExcludeStopWords_FromAddedDocumentContent() {
+    const int doc_id = 42;
+    const std::string content = std::string{ "cat in the city" };
+    const std::vector<int> ratings = { 1, 2, 3 };
+    {
+        SearchServer server(std::string{ "in the" });
+        server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+
+        ASSERT(server.FindTopDocuments(std::string{ "in" }).empty());
+    }
+}
+
+void Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(const std::string& query) {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+
+    const auto found_docs = server.FindTopDocuments(query);
+
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, 42);
+}
+
+void TestExcludedMinusWords_WithOneDocument_ResultEmpty() {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+
+    const auto found_docs = server.FindTopDocuments(std::string{ "cat -city" });
+
+    ASSERT(found_docs.empty());
+}
+
+void TestExcludedMinusWords_FromTwoDocuments_ResultEmpty() {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(104, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
+
+    const auto found_docs = server.FindTopDocuments(std::string{ "in -in" });
+
+    ASSERT(found_docs.empty());
+}
+
+void TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(const std::string& query, int etalonID) {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(42, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(104, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
+
+    const auto found_docs = server.FindTopDocuments(query);
+
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, etalonID);
+}
+
+void TestExcludedMinusWords_FromTwoDocuments_ResultTwoDocuments() {
+    const int doc_id = 42, doc_id1 = 104;
+    SearchServer server(std::string{ "" });
+    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(doc_id1, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
+
+    const auto found_docs = server.FindTopDocuments(std::string{ "in" });
+
+    ASSERT_EQUAL(found_docs.size(), 2u);
+    ASSERT_EQUAL(found_docs[0].id, doc_id);
+    ASSERT_EQUAL(found_docs[1].id, doc_id1);
+}
+
+void Test_GetDocumentCount_ResultEmpty() {
+    const int doc_id = 42, doc_id1 = 104;
+    SearchServer server(std::string{ "" });
+    
+    int document_count = server.GetDocumentCount();
+
+    ASSERT_EQUAL(document_count, 0);
+}
+
+void Test_GetDocumentCount_ResultThreeDocuments() {
+    const int doc_id = 42, doc_id1 = 104, doc_id2 = 210;
+    SearchServer server(std::string{ "" });
+    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(doc_id1, std::string{ "dog in perfect world" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(doc_id2, std::string{ "dog life is best life" }, DocumentStatus::ACTUAL, { 1 });
+
+    int document_count = server.GetDocumentCount();
+
+    ASSERT_EQUAL(document_count, 3);
+}
+
+void TestMatchDocument() {
+    const int doc_id = 42;
+    SearchServer server(std::string{ "" });
+    server.AddDocument(doc_id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    const std::string word1 = std::string{ "cat" };
+    const std::string word2 = std::string{ "in" };
+    const std::string word3 = std::string{ "cool" };
+    const std::string word4 = std::string{ "city" };
+
+    {
+        const auto& [find_words, status] = server.MatchDocument(std::string{ "cat in cool city" }, doc_id);
+
+        ASSERT(status == DocumentStatus::ACTUAL);
+        ASSERT(count(find_words.begin(), find_words.end(), word1));
+        ASSERT(count(find_words.begin(), find_words.end(), word2));
+        ASSERT(count(find_words.begin(), find_words.end(), word3));
+        ASSERT(count(find_words.begin(), find_words.end(), word4));
+        ASSERT_EQUAL(find_words.size(), 4u);
+    }
+    {
+        const auto& [find_words, status] = server.MatchDocument(std::string{ "cat bad giy city" }, doc_id);
+
+        ASSERT(status == DocumentStatus::ACTUAL);
+        ASSERT(count(find_words.begin(), find_words.end(), word1));
+        ASSERT(count(find_words.begin(), find_words.end(), word4));
+        ASSERT_EQUAL(find_words.size(), 2u);
+    }
+
+    {
+        const auto& [find_words, status] = server.MatchDocument(std::string{ "dog life is best life" }, doc_id);
+
+        ASSERT(status == DocumentStatus::ACTUAL);
+        ASSERT(find_words.empty());
+    }
+    {
+        const auto& [find_words, status] = server.MatchDocument(std::string{ "" }, doc_id);
+
+        ASSERT(status == DocumentStatus::ACTUAL);
+        ASSERT(find_words.empty());
+    }
+}
+
+SearchServer Сreating_Filled_Object(int id, int id1, int id2, int id3, int id4) {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(id, std::string{ "cat in cool city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(id1, std::string{ "dog in cool world" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(id2, std::string{ "throw duck in a river" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(id3, std::string{ "i am so good dog" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(id4, std::string{ "king of the hill" }, DocumentStatus::ACTUAL, { 1 });
+    return server;
+}
+
+void Test_FindTopDocuments_SortByRelevance() {
+    const int doc_id = 42;
+    const int doc_id1 = 104;
+    const int doc_id2 = 950;
+    const int doc_id3 = 272;
+    const int doc_id4 = 1080;
+    const int doc_id5 = 228;
+    SearchServer server = Сreating_Filled_Object(doc_id, doc_id1, doc_id2, doc_id3, doc_id4);  
+
+    {                                                   
+        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog" });
+
+        ASSERT_EQUAL(found_docs.size(), 3u);
+        ASSERT_EQUAL(found_docs[0].id, doc_id);
+        ASSERT_EQUAL(found_docs[1].id, doc_id1);
+        ASSERT_EQUAL(found_docs[2].id, doc_id3);
+    }
+
+    {
+        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog duck good hill" });
+
+        ASSERT_EQUAL(found_docs.size(), 5u);
+        ASSERT_EQUAL(found_docs[0].id, doc_id3);
+        ASSERT_EQUAL(found_docs[1].id, doc_id);
+        ASSERT_EQUAL(found_docs[2].id, doc_id4);
+        ASSERT_EQUAL(found_docs[3].id, doc_id2);
+        ASSERT_EQUAL(found_docs[4].id, doc_id1);
+    }
+
+    {
+        server.AddDocument(doc_id5, std::string{ "my room is good anouth" }, DocumentStatus::ACTUAL, { 1 });
+        const auto found_docs = server.FindTopDocuments(std::string{ "cat dog duck good hill" });
+
+        ASSERT_EQUAL(found_docs.size(), 5u);
+        ASSERT_EQUAL(found_docs[0].id, doc_id);
+        ASSERT_EQUAL(found_docs[1].id, doc_id4);
+        ASSERT_EQUAL(found_docs[2].id, doc_id3);
+        ASSERT_EQUAL(found_docs[3].id, doc_id2);
+        ASSERT_EQUAL(found_docs[4].id, doc_id1);
+    }
+}
+
+void Test_CalculateRating() {
+    const std::string content = std::string{ "cat in cool city" };
+    const int arithmetic_mean_document_1 = 2;
+    const int arithmetic_mean_document_2 = 5;
+    const int arithmetic_mean_document_3 = -3;
+    const int arithmetic_mean_document_4 = 1;
+    SearchServer server(std::string{ "" });
+    server.AddDocument(1, content, DocumentStatus::ACTUAL, { 1, 2, 3 });
+    server.AddDocument(2, content, DocumentStatus::ACTUAL, { 4, 28, -16 });
+    server.AddDocument(3, content, DocumentStatus::ACTUAL, { 4, -16, 3 });
+    server.AddDocument(4, content, DocumentStatus::ACTUAL, { 1, 3, 1 });
+    auto found_docs = server.FindTopDocuments(std::string{ "cat" });
+    std::sort(std::execution::par, found_docs.begin(), found_docs.end(), [](const Document& lhs, const Document& rhs) {
+        return lhs.id < rhs.id;
+    });
+
+    ASSERT_EQUAL(found_docs.size(), 4u);
+    ASSERT_EQUAL(found_docs[0].rating, arithmetic_mean_document_1);
+    ASSERT_EQUAL(found_docs[1].rating, arithmetic_mean_document_2);
+    ASSERT_EQUAL(found_docs[2].rating, arithmetic_mean_document_3);
+    ASSERT_EQUAL(found_docs[3].rating, arithmetic_mean_document_4);
+}
+
+void Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus status, int etalonId)
+{
+    const int doc_id = 42;
+    const int doc_id1 = 104;
+    const int doc_id2 = 950;
+    const int doc_id3 = 272;
+    const std::string content = std::string{ "cat in cool city" };
+    const std::vector ratings = { 1 };
+    SearchServer server(std::string{ "" });
+    server.AddDocument(doc_id, content, DocumentStatus::ACTUAL, ratings);
+    server.AddDocument(doc_id1, content, DocumentStatus::REMOVED, ratings);
+    server.AddDocument(doc_id2, content, DocumentStatus::BANNED, ratings);
+    server.AddDocument(doc_id3, content, DocumentStatus::IRRELEVANT, ratings);
+
+    const auto found_docs = server.FindTopDocuments(std::execution::seq, std::string{ "cat" }, status);
+
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, etalonId);
+}
+
+void Test_RelevanceCalculation() {
+    SearchServer server(std::string{ "" });
+    const double relevance_doc_1_and_2 = 0.135155;
+    const double relevance_doc_3 = 0.366204;
+    server.AddDocument(1, std::string{ "cat and dog" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cat and cow" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(3, std::string{ "city" }, DocumentStatus::ACTUAL, { 1 });
+
+    {
+        auto foundDocs = server.FindTopDocuments(std::string{ "cat" });
+        std::sort(std::execution::par, foundDocs.begin(), foundDocs.end(),
+            [](const Document& lhs, const Document& rhs) {
+            return lhs.id < rhs.id;
+        });
+
+        ASSERT_EQUAL(foundDocs.size(), 2u);
+        ASSERT_EQUAL(foundDocs[0].relevance, relevance_doc_1_and_2);  
+        ASSERT_EQUAL(foundDocs[1].relevance, relevance_doc_1_and_2);
+    }
+    {
+        auto foundDocs = server.FindTopDocuments(std::string{ "dog" });
+
+        ASSERT_EQUAL(foundDocs.size(), 1u);
+        ASSERT_EQUAL(foundDocs[0].relevance, relevance_doc_3);
+    }
+}
+
+void Test_FindTopDocuments_ParallelEqualsSequenced() {
+    const std::vector<std::string> vocabulary = { "cat", "dog", "curly", "nasty", "tail", "hat", "eyes", "pigeon" };
+    SearchServer server(std::string{ "and with" });
+    uint32_t seed = 17;
+    for (int id = 0; id < 40000; ++id) {
+        std::string text;
+        for (int i = 0; i < 4; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            text += vocabulary[(seed >> 16) % vocabulary.size()] + std::string{ " " };
+        }
+        server.AddDocument(id * 3, text, static_cast<DocumentStatus>(id % 3), { id % 11 });
+    }
+
+    const std::string query = std::string{ "curly cat -pigeon" };
+    const auto seq_docs = server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, 100);
+    const auto par_docs = server.FindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL, 100);
+
+    ASSERT_EQUAL(seq_docs.size(), 100u);
+    ASSERT_EQUAL(seq_docs.size(), par_docs.size());
+    for (size_t i = 0; i < seq_docs.size(); ++i) {
+        ASSERT_EQUAL(seq_docs[i].id, par_docs[i].id);
+        ASSERT_EQUAL(seq_docs[i].relevance, par_docs[i].relevance);
+        ASSERT_EQUAL(seq_docs[i].rating, par_docs[i].rating);
+    }
+
+    // два документа на краях огромного диапазона копятся в хеш-таблице, плотный диапазон - в массиве;
+    // результат от этого не зависит
+    const auto accumulate = [](RelevanceAccumulator& accumulator, int last_document_id) {
+        accumulator.Add(0, 1.0, [](int) { return true; });
+        accumulator.Add(last_document_id, 2.0, [](int) { return true; });
+        accumulator.Add(0, 0.5, [](int) { return true; });
+        return accumulator.Collect();
+    };
+    RelevanceAccumulator sparse(0, 4'000'000, 2);
+    ASSERT(!sparse.IsFlat());
+    ASSERT((accumulate(sparse, 4'000'000) == std::vector<std::pair<int, double>>{ { 0, 1.5 }, { 4'000'000, 2.0 } }));
+    RelevanceAccumulator dense(0, 1000, 500);
+    ASSERT(dense.IsFlat());
+    ASSERT((accumulate(dense, 1000) == std::vector<std::pair<int, double>>{ { 0, 1.5 }, { 1000, 2.0 } }));
+}
+
+void Test_FindTopDocuments_ResultCount() {
+    SearchServer server(std::string{ "" });
+    for (int id = 1; id <= 12; ++id) {
+        server.AddDocument(id, std::string{ "cat number " } + std::to_string(id), DocumentStatus::ACTUAL, { id });
+    }
+
+    ASSERT_EQUAL(server.FindTopDocuments(std::string{ "cat" }).size(), static_cast<size_t>(MAX_RESULT_DOCUMENT_COUNT));
+
+    const auto found_docs = server.FindTopDocuments(std::execution::seq, std::string{ "cat" }, DocumentStatus::ACTUAL, 10);
+    ASSERT_EQUAL(found_docs.size(), 10u);
+    for (size_t i = 0; i < found_docs.size(); ++i) {
+        ASSERT_EQUAL(found_docs[i].id, 12 - static_cast<int>(i));
+    }
+
+    server.SetMaxResultDocumentCount(20);
+    ASSERT_EQUAL(server.GetMaxResultDocumentCount(), 20u);
+    ASSERT_EQUAL(server.FindTopDocuments(std::string{ "cat" }).size(), 12u);
+    ASSERT(server.FindTopDocuments(std::execution::par, std::string{ "cat" }, DocumentStatus::ACTUAL, 0).empty());
+
+    // огромное K не резервируется заранее
+    TopDocuments top_documents(size_t{ 1 } << 40);
+    for (int id = 1; id <= 3; ++id) {
+        top_documents.Push({ id, 0.5 * id, id });
+    }
+    ASSERT(!top_documents.IsFull());
+    const auto top = top_documents.Extract();
+    ASSERT_EQUAL(top.size(), 3u);
+    ASSERT_EQUAL(top[0].id, 3);
+}
+
+void Test_FindTopDocuments_PrunedEqualsExhaustive() {
+    const std::vector<std::string> vocabulary = { "the", "cat", "dog", "curly", "nasty", "tail", "hat", "eyes", "pigeon", "john" };
+    SearchServer server(std::string{ "" });
+    uint32_t seed = 5;
+    for (int id = 0; id < 3000; ++id) {
+        std::string text;
+        seed = seed * 1103515245u + 12345u;
+        const int word_count = 1 + (seed >> 16) % 8;
+        for (int i = 0; i < word_count; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            // квадрат даёт перекос частот: первые слова словаря встречаются чаще
+            const uint32_t r = (seed >> 16) % 100;
+            text += vocabulary[r * r / 1000] + std::string{ " " };
+        }
+        server.AddDocument(id, text, DocumentStatus::ACTUAL, { static_cast<int>(seed % 7) });
+    }
+
+    for (const std::string& query : { std::string{ "the cat john" }, std::string{ "the dog -cat" }, std::string{ "curly nasty pigeon eyes" } }) {
+        const auto all_docs = server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, 100000);
+        for (const size_t result_count : { 1u, 5u, 37u }) {
+            const auto pruned_docs = server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, result_count);
+            const auto par_pruned_docs = server.FindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL, result_count);
+
+            ASSERT_EQUAL(pruned_docs.size(), std::min(result_count, all_docs.size()));
+            ASSERT_EQUAL(par_pruned_docs.size(), pruned_docs.size());
+            for (size_t i = 0; i < pruned_docs.size(); ++i) {
+                ASSERT_EQUAL(pruned_docs[i].id, all_docs[i].id);
+                ASSERT_EQUAL(par_pruned_docs[i].id, all_docs[i].id);
+                ASSERT_EQUAL(pruned_docs[i].relevance, all_docs[i].relevance);
+            }
+        }
+    }
+}
+
+void Test_IdfConsistency_ExactEqualsIncremental() {
+    SearchServer server(std::string{ "and with" });
+    server.AddDocument(1, std::string{ "white cat and yellow hat" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "curly cat curly tail" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, std::string{ "nasty dog with big eyes" }, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, std::string{ "nasty pigeon john" }, DocumentStatus::ACTUAL, { 4 });
+    server.RemoveDocument(3);
+    server.AddDocument(5, std::string{ "curly dog" }, DocumentStatus::ACTUAL, { 5 });
+
+    ASSERT(server.GetIdfConsistency() == IdfConsistency::INCREMENTAL);
+    const std::string query = std::string{ "curly nasty cat dog" };
+    const auto incremental_docs = server.FindTopDocuments(query);
+    server.SetIdfConsistency(IdfConsistency::EXACT);
+    const auto exact_docs = server.FindTopDocuments(query);
+
+    ASSERT_EQUAL(incremental_docs.size(), 4u);
+    ASSERT_EQUAL(exact_docs.size(), incremental_docs.size());
+    for (size_t i = 0; i < exact_docs.size(); ++i) {
+        ASSERT_EQUAL(exact_docs[i].id, incremental_docs[i].id);
+        ASSERT_EQUAL(exact_docs[i].relevance, incremental_docs[i].relevance);
+    }
+    // документ 5: curly (tf = 0.5, df = 2 из 4) и dog (tf = 0.5, df = 1 из 4)
+    ASSERT_EQUAL(exact_docs[0].id, 5);
+    ASSERT_EQUAL(exact_docs[0].relevance, 0.5 * std::log(2.0) + 0.5 * std::log(4.0));
+}
+
+void Test_AddDocuments_EqualsAddDocument() {
+    const std::vector<std::string> texts = {
+        "white cat and yellow hat", "curly cat curly tail", "nasty dog with big eyes", "nasty pigeon john", "curly dog and cat"
+    };
+    SearchServer one_by_one(std::string{ "and with" });
+    SearchServer batched(std::string{ "and with" });
+    one_by_one.AddDocument(100, std::string{ "old curly cat" }, DocumentStatus::ACTUAL, { 1 });
+    batched.AddDocument(100, std::string{ "old curly cat" }, DocumentStatus::ACTUAL, { 1 });
+
+    std::vector<NewDocument> documents;
+    for (int i = static_cast<int>(texts.size()) - 1; i >= 0; --i) {
+        const int id = i * 5;
+        one_by_one.AddDocument(id, texts[i], DocumentStatus::ACTUAL, { i, 2 * i });
+        documents.push_back({ id, texts[i], DocumentStatus::ACTUAL, { i, 2 * i } });
+    }
+    batched.AddDocuments(std::execution::par, documents);
+
+    ASSERT_EQUAL(batched.GetDocumentCount(), one_by_one.GetDocumentCount());
+    ASSERT(std::equal(batched.begin(), batched.end(), one_by_one.begin(), one_by_one.end()));
+    for (const int id : one_by_one) {
+        ASSERT_EQUAL(batched.GetWordFrequencies(id), one_by_one.GetWordFrequencies(id));
+    }
+    const auto expected_docs = one_by_one.FindTopDocuments(std::string{ "curly nasty cat -john" });
+    const auto found_docs = batched.FindTopDocuments(std::string{ "curly nasty cat -john" });
+    ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+    for (size_t i = 0; i < found_docs.size(); ++i) {
+        ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+        ASSERT_EQUAL(found_docs[i].relevance, expected_docs[i].relevance);
+        ASSERT_EQUAL(found_docs[i].rating, expected_docs[i].rating);
+    }
+}
+
+void Test_AddDocuments_InvalidBatchLeavesIndexUnchanged() {
+    SearchServer server(std::string{ "" });
+    server.AddDocument(1, std::string{ "cat" }, DocumentStatus::ACTUAL, { 1 });
+    const std::string bad_text = std::string{ "dog " } + char(12) + std::string{ "bad" };
+
+    const std::vector<std::vector<NewDocument>> invalid_batches = {
+        { { 2, "dog", DocumentStatus::ACTUAL, { 1 } }, { -3, "dog", DocumentStatus::ACTUAL, { 1 } } },
+        { { 2, "dog", DocumentStatus::ACTUAL, { 1 } }, { 1, "dog", DocumentStatus::ACTUAL, { 1 } } },
+        { { 2, "dog", DocumentStatus::ACTUAL, { 1 } }, { 2, "dog", DocumentStatus::ACTUAL, { 1 } } },
+        { { 2, "dog", DocumentStatus::ACTUAL, { 1 } }, { 3, bad_text, DocumentStatus::ACTUAL, { 1 } } },
+    };
+    for (const auto& batch : invalid_batches) {
+        bool is_thrown = false;
+        try {
+            server.AddDocuments(std::execution::par, batch);
+        }
+        catch (const std::invalid_argument&) {
+            is_thrown = true;
+        }
+        ASSERT(is_thrown);
+        ASSERT_EQUAL(server.GetDocumentCount(), 1);
+        ASSERT(server.FindTopDocuments(std::string{ "dog" }).empty());
+    }
+}
+
+void Test_Snapshot_SaveAndLoad() {
+    const std::string path = (std::filesystem::temp_directory_path() / "search_server_snapshot_test.bin").string();
+    {
+        SearchServer server(std::string{ "and with" });
+        server.AddDocument(1, std::string{ "white cat and yellow hat" }, DocumentStatus::ACTUAL, { 8, -3 });
+        server.AddDocument(2, std::string{ "curly cat curly tail" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
+        server.AddDocument(3, std::string{ "nasty dog with big eyes" }, DocumentStatus::BANNED, { 5, -12, 2, 1 });
+        server.AddDocument(4, std::string{ "nasty pigeon john" }, DocumentStatus::ACTUAL, { 9 });
+        server.SetMaxResultDocumentCount(3);
+        server.SaveSnapshot(path);
+    }
+
+    SearchServer loaded = SearchServer::LoadSnapshot(path);
+    ASSERT_EQUAL(loaded.GetDocumentCount(), 4);
+    // снимок того же индекса совпадает побайтно
+    {
+        const std::string resaved_path = (std::filesystem::temp_directory_path() / "search_server_snapshot_resaved_test.bin").string();
+        loaded.SaveSnapshot(resaved_path);
+        const auto read_file = [](const std::string& file_path) {
+            std::ifstream file(file_path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+        ASSERT(read_file(resaved_path) == read_file(path));
+        std::filesystem::remove(resaved_path);
+    }
+    ASSERT_EQUAL(loaded.GetMaxResultDocumentCount(), 3u);
+    ASSERT_EQUAL(loaded.GetWordFrequencies(2).at(std::string{ "curly" }), 0.5);
+    ASSERT(loaded.FindTopDocuments(std::string{ "and" }).empty());
+    {
+        const auto found_docs = loaded.FindTopDocuments(std::string{ "curly nasty cat" });
+        ASSERT_EQUAL(found_docs.size(), 3u);
+        ASSERT_EQUAL(found_docs[0].id, 2);
+        ASSERT_EQUAL(found_docs[1].id, 4);
+        ASSERT_EQUAL(found_docs[2].id, 1);
+        ASSERT_EQUAL(found_docs[1].rating, 9);
+    }
+    {
+        const auto [words, status] = loaded.MatchDocument(std::string{ "big dog -cat" }, 3);
+        ASSERT(status == DocumentStatus::BANNED);
+        ASSERT_EQUAL(words.size(), 2u);
+    }
+
+    // изменения копируют затронутые постинги из отображения
+    loaded.RemoveDocument(2);
+    loaded.AddDocument(5, std::string{ "curly dog" }, DocumentStatus::ACTUAL, { 1 });
+    {
+        const auto found_docs = loaded.FindTopDocuments(std::string{ "curly" });
+        ASSERT_EQUAL(found_docs.size(), 1u);
+        ASSERT_EQUAL(found_docs[0].id, 5);
+    }
+
+    // сервер разрушается, пока фоновое слияние ещё читает постинги из отображения снимка
+    {
+        const std::string large_path = (std::filesystem::temp_directory_path() / "search_server_snapshot_merge_test.bin").string();
+        {
+            SearchServer server(std::string{ "and" });
+            for (int id = 0; id < 20000; ++id) {
+                server.AddDocument(id, "w" + std::to_string(id % 101) + " and w" + std::to_string(id % 37) + " cat", DocumentStatus::ACTUAL, { id % 9 });
+            }
+            server.SaveSnapshot(large_path);
+        }
+        {
+            SearchServer large = SearchServer::LoadSnapshot(large_path);
+            std::vector<int> half_ids;
+            for (int id = 0; id < 20000; id += 2) {
+                half_ids.push_back(id);
+            }
+            // половина удалённых запускает переписывание сегмента снимка
+            large.RemoveDocuments(half_ids);
+        }
+        std::filesystem::remove(large_path);
+    }
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-3, std::ios::end);
+        file.put('#');
+    }
+    bool is_thrown = false;
+    try {
+        (void)SearchServer::LoadSnapshot(path);
+    }
+    catch (const std::runtime_error&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+    std::filesystem::remove(path);
+}
+
+void Test_PostingFormat_CompressedEqualsPlain() {
+    SearchServer plain(std::string{ "and" });
+    SearchServer compressed(std::string{ "and" });
+    compressed.SetPostingFormat(PostingFormat::COMPRESSED);
+    // id идут с разными шагами, чтобы в блоках встретились разные ширины разностей
+    std::vector<int> ids;
+    for (int i = 0; i < 1500; ++i) {
+        ids.push_back(i < 500 ? i : i < 1000 ? i * 37 : i * 100003);
+    }
+    ids.push_back(std::numeric_limits<int>::max());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const std::string text = "w" + std::to_string(i % 7) + " and w" + std::to_string(i % 13) + (i % 97 == 0 ? " rare" : "");
+        // половина документов приходит в compressed до перевода формата, половина после
+        if (i == 700) {
+            plain.SetPostingFormat(PostingFormat::COMPRESSED);
+            plain.SetPostingFormat(PostingFormat::PLAIN);
+        }
+        plain.AddDocument(ids[i], text, DocumentStatus::ACTUAL, { static_cast<int>(i % 10) });
+        compressed.AddDocument(ids[i], text, DocumentStatus::ACTUAL, { static_cast<int>(i % 10) });
+    }
+    plain.RemoveDocument(ids[97]);
+    compressed.RemoveDocument(ids[97]);
+
+    for (const std::string query : { "w1 w2", "w3 rare -w5", "rare w12", "w0 w1 w2 w3 w4 w5 w6 -w7" }) {
+        for (const size_t result_count : { size_t{ 3 }, size_t{ 10000 } }) {
+            const auto expected_docs = plain.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, result_count);
+            const auto found_docs = compressed.FindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL, result_count);
+            ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+            for (size_t i = 0; i < found_docs.size(); ++i) {
+                ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+                ASSERT(std::abs(found_docs[i].relevance - expected_docs[i].relevance) < 1e-6);
+            }
+        }
+    }
+    for (const int id : { ids[0], ids[97], ids[194], ids[1400], ids.back() }) {
+        if (plain.GetWordFrequencies(id).empty()) {
+            continue;
+        }
+        ASSERT(compressed.MatchDocument(std::string{ "w0 w6 rare -w12" }, id) == plain.MatchDocument(std::string{ "w0 w6 rare -w12" }, id));
+    }
+
+    // Contains ищет в блоках и в несжатом хвосте, в том числе id между постингами и за краями
+    PostingList postings(PostingFormat::COMPRESSED);
+    std::vector<Posting> odd_postings;
+    for (int id = 1; id < 1000; id += 2) {
+        odd_postings.push_back({ id, 1.0 });
+    }
+    postings.Merge(odd_postings);
+    for (const int id : { -1, 0, 1, 2, 255, 256, 257, 511, 997, 999, 1000 }) {
+        ASSERT_EQUAL(postings.Contains(id), id > 0 && id < 1000 && id % 2 == 1);
+    }
+}
+
+void Test_ConcurrentSearchServer_ReadWhileWriting() {
+    ConcurrentSearchServer server(std::string{ "and" });
+    static constexpr int DOCUMENT_COUNT = 300;
+    std::atomic<bool> is_done = false;
+    std::atomic<bool> is_consistent = true;
+
+    // читатель видит индекс только целиком до или после очередного изменения
+    std::thread reader([&server, &is_done, &is_consistent]() {
+        size_t last_found = 0;
+        while (!is_done) {
+            const auto found_docs = server.FindTopDocuments(std::execution::seq, std::string{ "cat" }, DocumentStatus::ACTUAL, DOCUMENT_COUNT);
+            const auto word_freqs = server.GetWordFrequencies(0);
+            if (found_docs.size() < last_found || (!found_docs.empty() && word_freqs.count("cat") == 0)) {
+                is_consistent = false;
+            }
+            last_found = found_docs.size();
+        }
+    });
+    for (int id = 0; id < DOCUMENT_COUNT; ++id) {
+        server.AddDocument(id, "cat and dog " + std::to_string(id), DocumentStatus::ACTUAL, { id });
+        server.RemoveDocument(id + DOCUMENT_COUNT);
+    }
+    is_done = true;
+    reader.join();
+
+    ASSERT(is_consistent);
+    ASSERT_EQUAL(server.GetDocumentCount(), DOCUMENT_COUNT);
+    ASSERT_EQUAL(server.FindTopDocuments(std::execution::seq, std::string{ "cat" }, DocumentStatus::ACTUAL, DOCUMENT_COUNT).size(), static_cast<size_t>(DOCUMENT_COUNT));
+    const auto ids = server.GetDocumentIds();
+    ASSERT_EQUAL(ids.size(), static_cast<size_t>(DOCUMENT_COUNT));
+    ASSERT_EQUAL(ids.back(), DOCUMENT_COUNT - 1);
+}
+
+void Test_Segments_EqualSingleSegment() {
+    SearchServer single(std::string{ "and" });
+    SearchServer segmented(std::string{ "and" });
+    segmented.SetMaxSegmentDocumentCount(8);
+    const auto add_document = [&single, &segmented](int id, const std::string& text) {
+        single.AddDocument(id, text, DocumentStatus::ACTUAL, { id % 7 });
+        segmented.AddDocument(id, text, DocumentStatus::ACTUAL, { id % 7 });
+    };
+    for (int id = 0; id < 200; ++id) {
+        add_document(id, "w" + std::to_string(id % 5) + " and w" + std::to_string(id % 11) + (id % 3 == 0 ? " cat" : ""));
+    }
+    // документ из запечатанного сегмента удаляется и добавляется заново уже в пишущийся сегмент
+    for (int id = 0; id < 200; id += 2) {
+        single.RemoveDocument(id);
+        segmented.RemoveDocument(id);
+    }
+    add_document(10, "cat dog");
+    segmented.WaitForMerges();
+    ASSERT(segmented.GetSegmentCount() < 200 / 8);
+    ASSERT_EQUAL(segmented.GetDocumentCount(), single.GetDocumentCount());
+
+    for (const std::string query : { "cat w1", "w2 w3 -cat", "dog", "w0 w1 w2 w3 w4 cat -w7" }) {
+        for (const size_t result_count : { size_t{ 2 }, size_t{ 1000 } }) {
+            const auto expected_docs = single.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, result_count);
+            const auto found_docs = segmented.FindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL, result_count);
+            ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+            for (size_t i = 0; i < found_docs.size(); ++i) {
+                ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+                ASSERT_EQUAL(found_docs[i].relevance, expected_docs[i].relevance);
+            }
+        }
+    }
+    ASSERT(segmented.MatchDocument(std::string{ "cat w0" }, 10) == single.MatchDocument(std::string{ "cat w0" }, 10));
+    ASSERT(segmented.MatchDocument(std::string{ "cat w0" }, 99) == single.MatchDocument(std::string{ "cat w0" }, 99));
+}
+
+void Test_ParseQuery_DuplicatesAndInvalidWords() {
+    SearchServer server(std::string{ "in" });
+    server.AddDocument(1, std::string{ "cat in city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "dog in city" }, DocumentStatus::ACTUAL, { 2 });
+
+    const auto expected_docs = server.FindTopDocuments(std::string{ "city -dog" });
+    const auto found_docs = server.FindTopDocuments(std::string{ " city  in city -dog -dog " });
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, expected_docs[0].id);
+    ASSERT_EQUAL(found_docs[0].relevance, expected_docs[0].relevance);
+    ASSERT(server.FindTopDocuments(std::string{ "" }).empty());
+    ASSERT_EQUAL(std::get<0>(server.MatchDocument(std::string{ "city city cat" }, 1)).size(), 2u);
+
+    for (const std::string& query : { std::string{ "cat --dog" }, std::string{ "cat -" }, std::string{ "cat- dog" }, std::string{ "cat - dog" }, std::string{ "ca" } + char(1) + "t" }) {
+        bool is_thrown = false;
+        try {
+            [[maybe_unused]] const auto documents = server.FindTopDocuments(query);
+        }
+        catch (const std::invalid_argument&) {
+            is_thrown = true;
+        }
+        ASSERT(is_thrown);
+    }
+}
+
+void Test_SplitIntoWords_Tokenizer() {
+    // границы 16-байтовых блоков, серии пробелов и байты >= 128 (кириллица в cp1251)
+    const std::string cyrillic{ char(-31), char(-14) };
+    const std::string text = "  first second   third-word " + cyrillic + " \xff\x80 0123456789abcdefghij  last";
+    std::vector<std::string_view> words;
+    ASSERT(SplitIntoWords(text, words));
+    const std::vector<std::string_view> expected_words = {
+        "first", "second", "third-word", cyrillic, "\xff\x80", "0123456789abcdefghij", "last"
+    };
+    ASSERT(words == expected_words);
+    // слова дописываются к уже найденным
+    ASSERT(SplitIntoWords(text, words));
+    ASSERT(std::equal(expected_words.begin(), expected_words.end(), words.begin() + expected_words.size(), words.end()));
+
+    for (const size_t position : { size_t{ 3 }, size_t{ 16 }, size_t{ 40 }, text.size() - 1 }) {
+        std::string bad_text = text;
+        bad_text[position] = char(31);
+        words.clear();
+        ASSERT(!SplitIntoWords(bad_text, words));
+        ASSERT(ContainsControlCharacters(bad_text));
+    }
+    ASSERT(!ContainsControlCharacters(text));
+
+    SearchServer server(std::string{ "  and   with " });
+    server.AddDocument(1, std::string{ "  cat and   dog " }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cat and dog" }, DocumentStatus::ACTUAL, { 1 });
+    ASSERT_EQUAL(server.GetWordFrequencies(1), server.GetWordFrequencies(2));
+
+    // текст стоп-слов проверяется тем же проходом токенизатора
+    const std::string bad_stop_words = std::string{ "and with" } + char(31) + "in";
+    for (const bool is_view : { false, true }) {
+        bool is_thrown = false;
+        try {
+            [[maybe_unused]] const SearchServer bad_server = is_view ? SearchServer(std::string_view{ bad_stop_words }) : SearchServer(bad_stop_words);
+        }
+        catch (const std::invalid_argument&) {
+            is_thrown = true;
+        }
+        ASSERT(is_thrown);
+    }
+}
+
+void Test_StopWordSet_Contains() {
+    std::set<std::string, std::less<>> words;
+    for (int i = 0; i < 3000; ++i) {
+        words.insert("w" + std::to_string(i * 7));
+    }
+    const StopWordSet stop_words(words);
+    ASSERT_EQUAL(stop_words.size(), words.size());
+    ASSERT_EQUAL(stop_words.GetWord(0), std::string_view(*words.begin()));
+
+    // копия не зависит от памяти исходного множества
+    const StopWordSet copy = stop_words;
+    for (int i = 0; i < 21000; ++i) {
+        const std::string word = "w" + std::to_string(i);
+        ASSERT_EQUAL(copy.Contains(word), i % 7 == 0);
+    }
+    ASSERT(!copy.Contains(std::string{ "w" }));
+    ASSERT(!copy.Contains(std::string{ "" }));
+    ASSERT(!StopWordSet{}.Contains(std::string{ "w0" }));
+
+    SearchServer server(std::string{ "in the" });
+    server.AddDocument(1, std::string{ "the cat in the city" }, DocumentStatus::ACTUAL, { 1 });
+    ASSERT_EQUAL(server.GetWordFrequencies(1).size(), 2u);
+    ASSERT(server.FindTopDocuments(std::string{ "in the" }).empty());
+}
+
+void Test_QueryExecutor_EqualsFindTopDocuments() {
+    SearchServer server(std::string{ "and in" });
+    const std::vector<std::string> words = { "cat", "dog", "city", "park", "tail", "eyes", "hat", "john" };
+    for (int id = 0; id < 300; ++id) {
+        std::string text;
+        for (int i = 0; i < 4; ++i) {
+            text += words[(id * 7 + i * (id % 5 + 1)) % words.size()] + " and ";
+        }
+        server.AddDocument(id, text, id % 10 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { id % 13 });
+    }
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < 150; ++i) {
+        queries.push_back(words[i % words.size()] + " " + words[(i / 3) % words.size()] + " -" + words[(i * 5 + 1) % words.size()] + " unknown");
+    }
+
+    const auto check_equal = [](const auto& found_docs, const std::vector<Document>& expected_docs) {
+        ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+        size_t i = 0;
+        for (const Document& document : found_docs) {
+            ASSERT_EQUAL(document.id, expected_docs[i].id);
+            ASSERT_EQUAL(document.relevance, expected_docs[i].relevance);
+            ++i;
+        }
+    };
+
+    // один поток и короткая очередь: Submit ждёт освобождения места
+    QueryExecutor executor(server, 1, 2);
+    std::vector<std::future<std::vector<Document>>> results;
+    for (const std::string& query : queries) {
+        results.push_back(executor.Submit(query));
+    }
+    auto batch_result = executor.SubmitBatch(queries);
+    const DocumentBatch batch = batch_result.get();
+    ASSERT_EQUAL(batch.size(), queries.size());
+    const auto processed = ProcessQueries(server, queries);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const std::vector<Document> expected_docs = server.FindTopDocuments(queries[i]);
+        check_equal(results[i].get(), expected_docs);
+        check_equal(batch[i], expected_docs);
+        check_equal(processed[i], expected_docs);
+    }
+    ASSERT_EQUAL(ProcessQueriesJoined(server, queries).size(), batch.documents.size());
+    ASSERT_EQUAL(executor.SubmitBatch({}).get().size(), 0u);
+
+    // малый пакет раздаётся всем потокам по запросу, большой - частями не больше MAX_BATCH_PART_SIZE
+    ASSERT_EQUAL(ComputeBatchPartSize(10, 8), 1u);
+    ASSERT_EQUAL(ComputeBatchPartSize(64, 1), 16u);
+    ASSERT_EQUAL(ComputeBatchPartSize(100000, 4), MAX_BATCH_PART_SIZE);
+    ASSERT_EQUAL(ComputeBatchPartSize(0, 0), 1u);
+
+    bool is_thrown = false;
+    try {
+        [[maybe_unused]] const auto documents = executor.SubmitBatch({ std::string{ "cat" }, std::string{ "cat --dog" } }).get();
+    }
+    catch (const std::invalid_argument&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+}
+
+void Test_ResultCache_InvalidatedOnChange() {
+    SearchServer server(std::string{ "in the" });
+    server.SetResultCacheCapacity(1 << 20);
+    server.AddDocument(1, std::string{ "cat in the city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "dog in the park" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, std::string{ "cat dog" }, DocumentStatus::BANNED, { 3 });
+
+    ASSERT_EQUAL(server.FindTopDocuments(std::string{ "cat city" }).size(), 1u);
+    // тот же разобранный запрос даёт тот же ключ
+    ASSERT_EQUAL(server.FindTopDocuments(std::string{ "city the cat cat" }).size(), 1u);
+    ASSERT_EQUAL(server.GetResultCacheSize(), 1u);
+    ASSERT_EQUAL(server.FindTopDocuments(std::string{ "cat city" }, DocumentStatus::BANNED).size(), 1u);
+    ASSERT_EQUAL(server.GetResultCacheSize(), 2u);
+    [[maybe_unused]] const auto documents = server.FindTopDocuments(std::string{ "cat" }, [](int document_id, DocumentStatus status, int rating) {
+        return true;
+    });
+    ASSERT_EQUAL(server.GetResultCacheSize(), 2u);
+
+    server.AddDocument(4, std::string{ "cat cat city" }, DocumentStatus::ACTUAL, { 4 });
+    auto found_docs = server.FindTopDocuments(std::string{ "cat city" });
+    ASSERT_EQUAL(found_docs.size(), 2u);
+    ASSERT_EQUAL(found_docs[1].id, 4);
+    server.RemoveDocument(4);
+    found_docs = server.FindTopDocuments(std::string{ "cat city" });
+    ASSERT_EQUAL(found_docs.size(), 1u);
+    ASSERT_EQUAL(found_docs[0].id, 1);
+
+    const std::vector<std::string> queries = { "cat", "dog -park", "cat city" };
+    const auto processed = ProcessQueries(server, queries);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto expected_docs = server.FindTopDocuments(queries[i]);
+        ASSERT_EQUAL(processed[i].size(), expected_docs.size());
+        for (size_t j = 0; j < expected_docs.size(); ++j) {
+            ASSERT_EQUAL(processed[i][j].id, expected_docs[j].id);
+            ASSERT_EQUAL(processed[i][j].relevance, expected_docs[j].relevance);
+        }
+    }
+
+    QueryResultCache cache(16 * 1024);
+    for (int i = 0; i < 1000; ++i) {
+        cache.Insert(std::to_string(i), 0, { { i, 1.0, 1 } });
+    }
+    ASSERT(cache.GetMemoryUsage() <= cache.GetCapacity());
+    ASSERT(cache.size() < 1000u);
+    ASSERT(cache.Find(std::string{ "999" }, 0).has_value());
+    ASSERT(!cache.Find(std::string{ "999" }, 1).has_value());
+    ASSERT(!cache.Find(std::string{ "999" }, 0).has_value());
+}
+
+void Test_StatusFilter_EqualsPredicate() {
+    SearchServer server(std::string{ "and" });
+    server.SetMaxSegmentDocumentCount(500);
+    const std::vector<std::string> words = { "cat", "dog", "city", "park", "tail", "eyes" };
+    const std::vector<DocumentStatus> statuses = { DocumentStatus::BANNED, DocumentStatus::IRRELEVANT, DocumentStatus::BANNED, DocumentStatus::ACTUAL, DocumentStatus::BANNED };
+    // id с пропусками больше страницы столбцов
+    for (int i = 0; i < 2000; ++i) {
+        const int id = i < 1500 ? i * 3 : 100000 + i * 17;
+        std::string text = words[i % words.size()] + " and " + words[(i / 7) % words.size()] + " " + words[(i * 5) % words.size()];
+        server.AddDocument(id, text, statuses[i % statuses.size()], { i % 11 });
+    }
+    for (int i = 0; i < 300; i += 2) {
+        server.RemoveDocument(i * 3);
+    }
+
+    for (const std::string& query : { std::string{ "cat city" }, std::string{ "dog -park" }, std::string{ "tail eyes cat dog" } }) {
+        for (const DocumentStatus status : { DocumentStatus::ACTUAL, DocumentStatus::BANNED, DocumentStatus::IRRELEVANT, DocumentStatus::REMOVED }) {
+            for (const size_t result_count : { size_t{ 5 }, size_t{ 5000 } }) {
+                const auto expected_docs = server.FindTopDocuments(std::execution::seq, query, [status](int document_id, DocumentStatus document_status, int rating) {
+                    return document_status == status;
+                }, result_count);
+                const auto found_docs = server.FindTopDocuments(std::execution::par, query, status, result_count);
+                ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+                for (size_t i = 0; i < found_docs.size(); ++i) {
+                    ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+                    ASSERT_EQUAL(found_docs[i].relevance, expected_docs[i].relevance);
+                    ASSERT_EQUAL(found_docs[i].rating, expected_docs[i].rating);
+                }
+            }
+        }
+    }
+
+    // номера выдаются подряд и не переиспользуются; наружу возвращаются внешние id
+    DocumentStore store;
+    ASSERT_EQUAL(store.Add(1000000, DocumentStatus::ACTUAL, 1, 1), 0);
+    ASSERT_EQUAL(store.Add(7, DocumentStatus::BANNED, 2, 2), 1);
+    for (int i = 0; i < 100; ++i) {
+        [[maybe_unused]] const int document_number = store.Add(100 + i, DocumentStatus::BANNED, 3, 3);
+    }
+    ASSERT_EQUAL(store.Add(5, DocumentStatus::ACTUAL, 4, 4), 102);
+    ASSERT_EQUAL(store.FindNext(DocumentStatus::ACTUAL, 0), 0);
+    ASSERT_EQUAL(store.FindNext(DocumentStatus::ACTUAL, 1), 102);
+    ASSERT_EQUAL(store.FindNext(DocumentStatus::ACTUAL, 103), -1);
+    ASSERT_EQUAL(store.GetDocumentId(102), 5);
+    ASSERT_EQUAL(store.GetRating(102), 4);
+    ASSERT_EQUAL(store.GetLength(102), 4u);
+    store.Remove(store.FindNumber(1000000));
+    // средняя длина считается по неудалённым: (2 + 100 * 3 + 4) / 102
+    ASSERT_EQUAL(store.GetAverageLength(), 3.0);
+    ASSERT(!store.HasStatus(0, DocumentStatus::ACTUAL));
+    ASSERT(!store.Contains(1000000));
+    ASSERT_EQUAL(store.size(), 102u);
+    ASSERT_EQUAL(store.GetNumberCount(), 103);
+    ASSERT_EQUAL(*store.begin(), 5);
+    ASSERT_EQUAL(store.Add(1000000, DocumentStatus::ACTUAL, 5, 5), 103);
+}
+
+void Test_RemoveDocument_TombstonesEqualRebuild() {
+    SearchServer removed(std::string{ "and" });
+    SearchServer rebuilt(std::string{ "and" });
+    removed.SetMaxSegmentDocumentCount(16);
+    for (int id = 0; id < 300; ++id) {
+        const std::string text = "w" + std::to_string(id % 7) + " and w" + std::to_string(id % 13) + (id % 4 == 0 ? " cat" : "");
+        const DocumentStatus status = id % 5 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        removed.AddDocument(id, text, status, { id % 9 });
+        if (id % 3 != 0) {
+            rebuilt.AddDocument(id, text, status, { id % 9 });
+        }
+    }
+    // надгробия и в запечатанных сегментах, и в пишущемся
+    for (int id = 0; id < 300; id += 3) {
+        removed.RemoveDocument(id);
+    }
+    ASSERT_EQUAL(removed.GetDocumentCount(), rebuilt.GetDocumentCount());
+
+    const auto is_even = [](int document_id, DocumentStatus, int) {
+        return document_id % 2 == 0;
+    };
+    const auto check_queries = [&removed, &rebuilt, &is_even]() {
+        for (const std::string query : { "cat w1", "w2 w3 -cat", "w0 w1 w2 w3 w4 w5 w6 cat -w7" }) {
+            for (const size_t result_count : { size_t{ 3 }, size_t{ 1000 } }) {
+                const auto expected_docs = rebuilt.FindTopDocuments(std::execution::seq, query, is_even, result_count);
+                const auto found_docs = removed.FindTopDocuments(std::execution::par, query, is_even, result_count);
+                ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+                for (size_t i = 0; i < found_docs.size(); ++i) {
+                    ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+                    ASSERT_EQUAL(found_docs[i].relevance, expected_docs[i].relevance);
+                }
+                ASSERT_EQUAL(removed.FindTopDocuments(std::execution::seq, query, DocumentStatus::BANNED, result_count).size(),
+                    rebuilt.FindTopDocuments(std::execution::seq, query, DocumentStatus::BANNED, result_count).size());
+            }
+        }
+    };
+    check_queries();
+    bool is_thrown = false;
+    try {
+        [[maybe_unused]] const auto match = removed.MatchDocument(std::string{ "cat" }, 12);
+    }
+    catch (const std::out_of_range&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+
+    // после слияний постинги удалённых документов физически исчезают, результаты те же
+    removed.WaitForMerges();
+    ASSERT(removed.GetSegmentCount() < 300 / 16);
+    check_queries();
+
+    // при постоянных добавлениях и удалениях номера удалённых документов освобождаются сжатием нумерации
+    SearchServer churned(std::string{ "and" });
+    churned.SetPositionIndexing(true);
+    churned.SetMaxSegmentDocumentCount(16);
+    const auto make_text = [](int id) {
+        return "w" + std::to_string(id % 7) + " and w" + std::to_string(id % 13) + (id % 4 == 0 ? " curly cat" : " cat");
+    };
+    const int live_count = 40;
+    for (int id = 0; id < 6000; ++id) {
+        churned.AddDocument(id, make_text(id), id % 5 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { id % 9 });
+        if (id >= live_count && id % 100 == 0) {
+            std::vector<int> batch;
+            for (int removed_id = id - live_count; removed_id > id - live_count - 100 && removed_id >= 0; --removed_id) {
+                batch.push_back(removed_id);
+            }
+            churned.RemoveDocuments(batch);
+        }
+        else if (id >= live_count) {
+            churned.RemoveDocument(id - live_count);
+        }
+        ASSERT(churned.GetDocumentNumberCount() <= 3 * 1024);
+    }
+    ASSERT_EQUAL(churned.GetDocumentCount(), live_count);
+    SearchServer fresh(std::string{ "and" });
+    fresh.SetPositionIndexing(true);
+    for (int id = 6000 - live_count; id < 6000; ++id) {
+        fresh.AddDocument(id, make_text(id), id % 5 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { id % 9 });
+    }
+    for (const std::string query : { "cat w1", "w2 w3 -curly", "\"curly cat\" w4", "w0 w1 w2 w3 w4 w5 w6 cat -w7" }) {
+        const auto expected_docs = fresh.FindTopDocuments(std::execution::seq, query, is_even, 1000);
+        const auto found_docs = churned.FindTopDocuments(std::execution::par, query, is_even, 1000);
+        ASSERT_EQUAL(found_docs.size(), expected_docs.size());
+        for (size_t i = 0; i < found_docs.size(); ++i) {
+            ASSERT_EQUAL(found_docs[i].id, expected_docs[i].id);
+            ASSERT_EQUAL(found_docs[i].relevance, expected_docs[i].relevance);
+        }
+    }
+    for (int id = 6000 - live_count; id < 6000; ++id) {
+        ASSERT(std::get<0>(churned.MatchDocument(std::string{ "\"curly cat\" w3" }, id)) == std::get<0>(fresh.MatchDocument(std::string{ "\"curly cat\" w3" }, id)));
+        ASSERT(churned.GetWordFrequencies(id) == fresh.GetWordFrequencies(id));
+    }
+}
+
+void Test_RemoveDuplicates_ExactAndNear() {
+    SearchServer server(std::string{ "and with" });
+    server.AddDocument(1, std::string{ "funny pet and nasty rat" }, DocumentStatus::ACTUAL, { 7, 2, 7 });
+    server.AddDocument(2, std::string{ "funny pet with curly hair" }, DocumentStatus::ACTUAL, { 1, 2 });
+    // те же слова, другие частоты и порядок; стоп-слова не учитываются
+    server.AddDocument(3, std::string{ "funny pet with curly hair curly" }, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(4, std::string{ "hair curly pet funny and" }, DocumentStatus::BANNED, { 1, 2 });
+    server.AddDocument(5, std::string{ "nasty rat funny pet" }, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(6, std::string{ "funny pet with curly hair and long tail" }, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(7, std::string{ "very nasty rat and not very funny pet" }, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(8, std::string{ "dog" }, DocumentStatus::ACTUAL, { 1, 2 });
+
+    ASSERT_EQUAL(FindDuplicates(server), (std::vector<int>{ 3, 4, 5 }));
+    ASSERT_EQUAL(FindNearDuplicates(server, 1.0), (std::vector<int>{ 3, 4, 5 }));
+    // 6 совпадает со 2 на 4 словах из 6, 7 с 1 - на 4 из 6
+    ASSERT_EQUAL(FindNearDuplicates(server, 0.6), (std::vector<int>{ 3, 4, 5, 6, 7 }));
+
+    ASSERT_EQUAL(RemoveDuplicates(server), (std::vector<int>{ 3, 4, 5 }));
+    ASSERT_EQUAL(server.GetDocumentCount(), 5);
+    ASSERT(RemoveDuplicates(server).empty());
+    bool is_thrown = false;
+    try {
+        [[maybe_unused]] const auto duplicate_ids = FindNearDuplicates(server, 0.0);
+    }
+    catch (const std::invalid_argument&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+}
+
+void Test_RequestStatistics_SlidingWindow() {
+    using namespace std::chrono;
+    RequestStatistics statistics(minutes(60), 60);
+    // начало выровнено по интервалу, чтобы граница окна была точной
+    const RequestStatistics::Clock::time_point start{ duration_cast<minutes>(RequestStatistics::Clock::now().time_since_epoch()) };
+    for (int minute = 0; minute < 90; ++minute) {
+        const auto time = start + minutes(minute);
+        statistics.Record(minute % 3 == 0 ? 0 : 5, microseconds(minute < 45 ? 100 : 1000), time);
+        statistics.Record(5, microseconds(100), time);
+    }
+    // в окне последние 60 минут: 30..89
+    const auto now = start + minutes(89) + seconds(1);
+    ASSERT_EQUAL(statistics.GetRequestCount(now), 120u);
+    ASSERT_EQUAL(statistics.GetNoResultCount(now), 20u);
+    ASSERT(std::abs(statistics.GetNoResultRate(now) - 1.0 / 6) < 1e-9);
+    // 45 из 120 запросов медленные
+    ASSERT(statistics.GetLatencyPercentile(50.0, now) < microseconds(120));
+    ASSERT(statistics.GetLatencyPercentile(99.0, now) > microseconds(880));
+    ASSERT(statistics.GetLatencyPercentile(99.0, now) < microseconds(1130));
+    ASSERT_EQUAL(statistics.GetRequestCount(start + hours(3)), 0u);
+
+    // записи из нескольких потоков не теряются
+    RequestStatistics concurrent_statistics(hours(1));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&concurrent_statistics]() {
+            for (int j = 0; j < 10000; ++j) {
+                concurrent_statistics.Record(j % 2, microseconds(j % 50));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUAL(concurrent_statistics.GetRequestCount(), 40000u);
+    ASSERT_EQUAL(concurrent_statistics.GetNoResultCount(), 20000u);
+
+    SearchServer server(std::string{ "and" });
+    server.AddDocument(1, std::string{ "curly cat" }, DocumentStatus::ACTUAL, { 1 });
+    RequestQueue request_queue(server);
+    for (int i = 0; i < 10; ++i) {
+        [[maybe_unused]] const auto found_docs = request_queue.AddFindRequest(i % 2 == 0 ? std::string{ "dog" } : std::string{ "cat" });
+    }
+    ASSERT_EQUAL(request_queue.GetNoResultRequests(), 5);
+    ASSERT_EQUAL(request_queue.GetStatistics().GetRequestCount(), 10u);
+}
+
+void Test_PhraseQueries_PositionIndex() {
+    SearchServer server(std::string{ "in the" });
+    server.SetPositionIndexing(true);
+    server.AddDocument(1, std::string{ "curly cat in the city" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cat curly dog" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocuments({ { 3, "curly dog and cat and city", DocumentStatus::ACTUAL, { 3 } },
+        { 4, "the curly cat", DocumentStatus::ACTUAL, { 4 } } });
+    const auto found_ids = [&server](const std::string& query) {
+        std::set<int> ids;
+        for (const Document& document : server.FindTopDocuments(query)) {
+            ids.insert(document.id);
+        }
+        return ids;
+    };
+
+    ASSERT_EQUAL(found_ids("\"curly cat\""), (std::set<int>{ 1, 4 }));
+    ASSERT_EQUAL(found_ids("\"curly cat\" -city"), (std::set<int>{ 4 }));
+    // стоп-слова занимают позиции и во фразе, и в документе
+    ASSERT(found_ids("\"cat city\"").empty());
+    ASSERT_EQUAL(found_ids("\"cat in the city\""), (std::set<int>{ 1 }));
+    ASSERT_EQUAL(found_ids("\"cat the in city\" dog"), (std::set<int>{ 1 }));
+    // стоп-слова по краям фразы отбрасываются одинаково: 2 начинается с cat, 4 кончается на cat
+    ASSERT_EQUAL(found_ids("\"the cat curly\""), (std::set<int>{ 2 }));
+    ASSERT_EQUAL(found_ids("\"curly cat the\""), found_ids("\"curly cat\""));
+    ASSERT_EQUAL(found_ids("\"in the\" cat"), found_ids("cat"));
+    ASSERT_EQUAL(found_ids("\"curly dog\" \"and city\""), (std::set<int>{ 3 }));
+    ASSERT(found_ids("\"curly bird\"").empty());
+    ASSERT(std::get<0>(server.MatchDocument(std::string{ "\"curly cat\"" }, 2)).empty());
+    ASSERT_EQUAL(std::get<0>(server.MatchDocument(std::string{ "\"curly cat\"" }, 1)).size(), 2u);
+    for (const std::string query : { "\"curly cat", "\"curly \"cat\"\"", "\"curly -cat\"", "\"\" cat" }) {
+        bool is_thrown = false;
+        try {
+            [[maybe_unused]] const auto documents = server.FindTopDocuments(query);
+        }
+        catch (const std::invalid_argument&) {
+            is_thrown = true;
+        }
+        ASSERT(is_thrown);
+    }
+
+    // близость: "curly dog" стоят рядом в 2 и 3, в 1 и 4 собаки нет
+    const auto plain_docs = server.FindTopDocuments(std::string{ "cat dog" });
+    server.SetProximityWeight(1.0);
+    const auto proximity_docs = server.FindTopDocuments(std::string{ "cat dog" });
+    ASSERT_EQUAL(proximity_docs.size(), plain_docs.size());
+    for (const Document& document : proximity_docs) {
+        const auto plain = std::find_if(plain_docs.begin(), plain_docs.end(), [&document](const Document& plain_document) {
+            return plain_document.id == document.id;
+        });
+        ASSERT(plain != plain_docs.end());
+        // в 2 "cat curly dog" окно из трёх слов, в 3 "dog and cat" - тоже, в 1 и 4 собаки нет
+        const double factor = document.id == 2 || document.id == 3 ? 1.5 : 1.0;
+        ASSERT(std::abs(document.relevance - plain->relevance * factor) < 1e-12);
+    }
+    // K больше числа документов, в том числе умноженное для близости, не резервируется под кандидатов фраз
+    for (const double weight : { 1.0, 0.0 }) {
+        server.SetProximityWeight(weight);
+        const auto large_k_docs = server.FindTopDocuments(std::execution::seq, std::string{ "\"curly cat\"" }, DocumentStatus::ACTUAL, size_t{ 1 } << 40);
+        ASSERT_EQUAL(large_k_docs.size(), 2u);
+        ASSERT_EQUAL(large_k_docs.size(), server.FindTopDocuments(std::execution::seq, std::string{ "\"curly cat\"" }, DocumentStatus::ACTUAL, 5).size());
+    }
+    server.SetProximityWeight(1.0);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "search_server_positions_test.bin").string();
+    server.SaveSnapshot(path);
+    const SearchServer loaded = SearchServer::LoadSnapshot(path);
+    ASSERT(loaded.GetPositionIndexing());
+    ASSERT_EQUAL(loaded.FindTopDocuments(std::string{ "\"curly cat\" -city" }).size(), 1u);
+    ASSERT_EQUAL(loaded.FindTopDocuments(std::string{ "\"curly dog\"" }).size(), 2u);
+
+    // удаление освобождает позиции, и после уплотнения оставшиеся документы находятся по-прежнему
+    server.RemoveDocument(1);
+    server.RemoveDocument(3);
+    ASSERT_EQUAL(found_ids("\"curly cat\""), (std::set<int>{ 4 }));
+    ASSERT_EQUAL(found_ids("\"curly dog\""), (std::set<int>{ 2 }));
+    server.RemoveDocument(2);
+    ASSERT_EQUAL(found_ids("\"the curly cat\""), (std::set<int>{ 4 }));
+
+    // top-K по фразе - это лучшие по обычному запросу из тех же слов среди документов, где фраза есть;
+    // сегменты и удалённые документы проверяют пересечение постингов по частям
+    SearchServer random_server(std::string{ "w0" });
+    random_server.SetPositionIndexing(true);
+    random_server.SetMaxSegmentDocumentCount(64);
+    uint32_t seed = 3;
+    for (int id = 0; id < 600; ++id) {
+        std::string text;
+        for (int i = 0; i < 12; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            text += "w" + std::to_string((seed >> 16) % 6) + " ";
+        }
+        random_server.AddDocument(id, text, DocumentStatus::ACTUAL, { id % 4 });
+    }
+    for (int id = 0; id < 600; id += 9) {
+        random_server.RemoveDocument(id);
+    }
+    for (const auto& [phrase_query, plain_query] : std::vector<std::pair<std::string, std::string>>{
+        { "\"w1 w2\"", "w1 w2" }, { "\"w3 w0 w3\" w5", "w3 w5" }, { "\"w1 w2 w1\" -w4", "w1 w2 -w4" }, { "\"w2 w4\" \"w5 w1\"", "w2 w4 w5 w1" } }) {
+        std::vector<Document> expected;
+        for (const Document& document : random_server.FindTopDocuments(std::execution::seq, plain_query, DocumentStatus::ACTUAL, 1000)) {
+            if (!std::get<0>(random_server.MatchDocument(phrase_query, document.id)).empty()) {
+                expected.push_back(document);
+            }
+        }
+        expected.resize(std::min<size_t>(expected.size(), MAX_RESULT_DOCUMENT_COUNT));
+        const auto phrase_documents = random_server.FindTopDocuments(phrase_query);
+        ASSERT(!expected.empty());
+        ASSERT_EQUAL(phrase_documents.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUAL(phrase_documents[i].id, expected[i].id);
+            ASSERT_EQUAL(phrase_documents[i].relevance, expected[i].relevance);
+        }
+    }
+
+    // без позиционного индекса кавычки - часть слова: "curly и cat" ищутся как обычные слова
+    SearchServer plain_server(std::string{ "in the" });
+    plain_server.AddDocument(1, std::string{ "\"curly cat\" in the city" }, DocumentStatus::ACTUAL, { 1 });
+    plain_server.AddDocument(2, std::string{ "curly cat" }, DocumentStatus::ACTUAL, { 2 });
+    const auto plain_docs_quoted = plain_server.FindTopDocuments(std::string{ "\"curly cat\"" });
+    ASSERT_EQUAL(plain_docs_quoted.size(), 1u);
+    ASSERT_EQUAL(plain_docs_quoted[0].id, 1);
+    ASSERT_EQUAL(plain_server.FindTopDocuments(std::string{ "\"cat" }).size(), 0u);
+    ASSERT_EQUAL(std::get<0>(plain_server.MatchDocument(std::string{ "\"curly -city" }, 1)).size(), 0u);
+    ASSERT_EQUAL(std::get<0>(plain_server.MatchDocument(std::string{ "\"curly dog" }, 1)).size(), 1u);
+}
+
+// число совпавших слов запроса; без UpperBound, поэтому top-K считается полным перебором
+struct MatchedWordCountScoring {
+    double TermWeight(const TermStatistics&, const CollectionStatistics&) const noexcept {
+        return 1.0;
+    }
+
+    double Score(double, double term_weight) const noexcept {
+        return term_weight;
+    }
+};
+
+void Test_ScoringPolicies_Bm25AndCustom() {
+    SearchServer server(std::string{ "and" });
+    server.AddDocument(1, std::string{ "cat cat dog" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cat and bird bird bird bird" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, std::string{ "dog" }, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, std::string{ "cat dog" }, DocumentStatus::BANNED, { 4 });
+    const auto find_relevances = [&server](const auto& scoring) {
+        std::map<int, double> relevances;
+        for (const Document& document : server.FindTopDocuments(std::execution::seq, std::string{ "cat dog" }, DocumentStatus::ACTUAL, 10, scoring)) {
+            relevances[document.id] = document.relevance;
+        }
+        return relevances;
+    };
+
+    // TF-IDF как политика совпадает с поиском по умолчанию побитово
+    std::map<int, double> default_relevances;
+    for (const Document& document : server.FindTopDocuments(std::string{ "cat dog" })) {
+        default_relevances[document.id] = document.relevance;
+    }
+    ASSERT(find_relevances(TfIdfScoring{}) == default_relevances);
+
+    // BM25 с k1 = 1.2, b = 0.75: длины 3, 5, 1 и 2 (стоп-слово не считается), avgdl = 11 / 4,
+    // у обоих слов df = 3 из N = 4
+    const double idf = std::log(1.0 + (4.0 - 3.0 + 0.5) / (3.0 + 0.5));
+    const auto bm25 = [](double count, double length) {
+        return count * 2.2 / (count + 1.2 * (0.25 + 0.75 * length / (11.0 / 4.0)));
+    };
+    const std::map<int, double> bm25_relevances = find_relevances(Bm25Scoring{ 1.2, 0.75 });
+    ASSERT_EQUAL(bm25_relevances.size(), 3u);
+    ASSERT(std::abs(bm25_relevances.at(1) - idf * (bm25(2, 3) + bm25(1, 3))) < 1e-12);
+    ASSERT(std::abs(bm25_relevances.at(2) - idf * bm25(1, 5)) < 1e-12);
+    ASSERT(std::abs(bm25_relevances.at(3) - idf * bm25(1, 1)) < 1e-12);
+
+    const std::map<int, double> custom_relevances = find_relevances(MatchedWordCountScoring{});
+    ASSERT(custom_relevances == (std::map<int, double>{ { 1, 2.0 }, { 2, 1.0 }, { 3, 1.0 } }));
+    const auto with_predicate = server.FindTopDocuments(std::execution::par, std::string{ "cat dog -bird" },
+        [](int, DocumentStatus, int rating) { return rating > 1; }, 10, MatchedWordCountScoring{});
+    ASSERT_EQUAL(with_predicate.size(), 2u);
+    ASSERT_EQUAL(with_predicate[0].id, 4);
+    ASSERT_EQUAL(with_predicate[0].relevance, 2.0);
+
+    // отсечение по границе BM25 не меняет top-K
+    SearchServer large_server(std::string{ "and" });
+    for (int id = 0; id < 2000; ++id) {
+        std::string text;
+        for (int i = 0; i <= id % 11; ++i) {
+            text += "w" + std::to_string((id * 7 + i * i) % 13) + " ";
+        }
+        large_server.AddDocument(id, text, DocumentStatus::ACTUAL, { id % 5 });
+    }
+    const Bm25Scoring scoring(1.5, 0.9);
+    for (const std::string query : { "w1 w2", "w3 w5 w7 -w0", "w12" }) {
+        const auto pruned = large_server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, 5, scoring);
+        auto all = large_server.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, 100000, scoring);
+        all.resize(std::min(all.size(), size_t{ 5 }));
+        ASSERT_EQUAL(pruned.size(), all.size());
+        for (size_t i = 0; i < pruned.size(); ++i) {
+            ASSERT_EQUAL(pruned[i].id, all[i].id);
+            ASSERT_EQUAL(pruned[i].relevance, all[i].relevance);
+        }
+    }
+
+    // длины документов переживают снимок
+    const std::string path = (std::filesystem::temp_directory_path() / "search_server_scoring_test.bin").string();
+    server.SaveSnapshot(path);
+    const SearchServer loaded = SearchServer::LoadSnapshot(path);
+    const auto loaded_documents = loaded.FindTopDocuments(std::execution::seq, std::string{ "cat dog" }, DocumentStatus::ACTUAL, 10, Bm25Scoring{ 1.2, 0.75 });
+    ASSERT_EQUAL(loaded_documents.size(), 3u);
+    for (const Document& document : loaded_documents) {
+        ASSERT_EQUAL(document.relevance, bm25_relevances.at(document.id));
+    }
+
+    bool is_thrown = false;
+    try {
+        [[maybe_unused]] const Bm25Scoring invalid(1.2, 1.5);
+    }
+    catch (const std::invalid_argument&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+}
+
+void Test_PrefixQueries_SortedDictionary() {
+    // термов больше порога хвоста: часть лежит в сжатых блоках, часть - в хвосте
+    TermDictionary dictionary;
+    std::vector<std::string> terms;
+    for (int i = 4999; i >= 0; --i) {
+        terms.push_back("t" + std::to_string(i));
+    }
+    terms.push_back("t");
+    terms.push_back("u");
+    for (const std::string& term : terms) {
+        [[maybe_unused]] const TermDictionary::TermId term_id = dictionary.Intern(term);
+    }
+    for (const std::string prefix : { "t12", "t4999", "t49999", "t", "", "s", "v" }) {
+        std::set<std::string> expected;
+        for (const std::string& term : terms) {
+            if (term.compare(0, prefix.size(), prefix) == 0) {
+                expected.insert(term);
+            }
+        }
+        std::set<std::string> found;
+        dictionary.ForEachWithPrefix(prefix, [&dictionary, &found](std::string_view term, TermDictionary::TermId term_id) {
+            ASSERT_EQUAL(dictionary.GetTerm(term_id), term);
+            found.insert(std::string{ term });
+        });
+        ASSERT(found == expected);
+    }
+
+    SearchServer server(std::string{ "and" });
+    server.AddDocument(1, std::string{ "cat" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cats and dogs" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, std::string{ "catalog cat" }, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, std::string{ "dog" }, DocumentStatus::ACTUAL, { 4 });
+    server.AddDocument(5, std::string{ "scat" }, DocumentStatus::ACTUAL, { 5 });
+    const auto found_ids = [&server](const std::string& query) {
+        std::set<int> ids;
+        for (const Document& document : server.FindTopDocuments(query)) {
+            ids.insert(document.id);
+        }
+        return ids;
+    };
+
+    ASSERT_EQUAL(found_ids("cat*"), (std::set<int>{ 1, 2, 3 }));
+    ASSERT_EQUAL(found_ids("cat* -dog*"), (std::set<int>{ 1, 3 }));
+    ASSERT_EQUAL(found_ids("bird*"), std::set<int>{});
+    // раскрытие равносильно запросу со всеми термами префикса
+    const auto expanded = server.FindTopDocuments(std::string{ "cat*" });
+    const auto explicit_terms = server.FindTopDocuments(std::string{ "cat cats catalog" });
+    ASSERT_EQUAL(expanded.size(), explicit_terms.size());
+    for (size_t i = 0; i < expanded.size(); ++i) {
+        ASSERT_EQUAL(expanded[i].id, explicit_terms[i].id);
+        ASSERT_EQUAL(expanded[i].relevance, explicit_terms[i].relevance);
+    }
+    ASSERT(std::get<0>(server.MatchDocument(std::string{ "cat*" }, 2)) == std::vector<std::string_view>{ "cats" });
+
+    // при ограничении остаются самые частые термы: cat есть в двух документах
+    server.SetMaxPrefixExpansion(1);
+    ASSERT_EQUAL(found_ids("cat*"), (std::set<int>{ 1, 3 }));
+    server.SetMaxPrefixExpansion(64);
+    server.RemoveDocument(2);
+    ASSERT_EQUAL(found_ids("cats*"), std::set<int>{});
+    // без позиционного индекса кавычка - символ префикса
+    ASSERT_EQUAL(found_ids("\"cat*\""), std::set<int>{});
+
+    // одиночная звёздочка - обычное слово
+    const std::set<int> cat_ids = found_ids("cat");
+    server.AddDocument(6, std::string{ "cat * dog" }, DocumentStatus::ACTUAL, { 6 });
+    ASSERT_EQUAL(found_ids("*"), (std::set<int>{ 6 }));
+    ASSERT_EQUAL(found_ids("cat -*"), cat_ids);
+}
+
+void Test_FuzzyQueries_LevenshteinAutomaton() {
+    // короткие слова из трёх букв: у каждого много соседей, а мёртвые префиксы встречаются и в блоках, и в хвосте
+    TermDictionary dictionary;
+    std::vector<std::string> terms;
+    uint32_t seed = 11;
+    for (int i = 0; i < 3000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        std::string term(1 + (seed >> 16) % 7, 'a');
+        for (char& c : term) {
+            seed = seed * 1103515245u + 12345u;
+            c = static_cast<char>('a' + (seed >> 16) % 3);
+        }
+        if (dictionary.Find(term) == TermDictionary::NO_TERM) {
+            [[maybe_unused]] const TermDictionary::TermId term_id = dictionary.Intern(term);
+            terms.push_back(term);
+        }
+    }
+    const auto edit_distance = [](const std::string& lhs, const std::string& rhs) {
+        std::vector<size_t> row(rhs.size() + 1);
+        std::iota(row.begin(), row.end(), size_t{ 0 });
+        for (size_t i = 1; i <= lhs.size(); ++i) {
+            size_t diagonal = row[0];
+            row[0] = i;
+            for (size_t j = 1; j <= rhs.size(); ++j) {
+                const size_t above = row[j];
+                row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (lhs[i - 1] == rhs[j - 1] ? 0 : 1) });
+                diagonal = above;
+            }
+        }
+        return row.back();
+    };
+    for (const std::string word : { "abcab", "aaaaaaa", "c", "", "abcabcabca" }) {
+        for (size_t max_distance : { 0, 1, 2 }) {
+            std::map<std::string, size_t> expected;
+            for (const std::string& term : terms) {
+                if (const size_t distance = edit_distance(term, word); distance <= max_distance) {
+                    expected[term] = distance;
+                }
+            }
+            std::map<std::string, size_t> found;
+            LevenshteinAutomaton automaton(word, max_distance);
+            dictionary.ForEachAccepted(automaton, [&dictionary, &found, &automaton](std::string_view term, TermDictionary::TermId term_id) {
+                ASSERT_EQUAL(dictionary.GetTerm(term_id), term);
+                found[std::string{ term }] = automaton.GetDistance();
+            });
+            ASSERT(found == expected);
+        }
+    }
+
+    SearchServer server(std::string{ "and" });
+    server.AddDocument(1, std::string{ "cat" }, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, std::string{ "cot" }, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, std::string{ "cart and dog" }, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, std::string{ "cat fish bird" }, DocumentStatus::ACTUAL, { 4 });
+    server.AddDocument(5, std::string{ "parrot" }, DocumentStatus::ACTUAL, { 5 });
+    const auto found_ids = [&server](const std::string& query) {
+        std::vector<int> ids;
+        for (const Document& document : server.FindTopDocuments(query)) {
+            ids.push_back(document.id);
+        }
+        return ids;
+    };
+
+    ASSERT_EQUAL(found_ids("catt"), std::vector<int>{});
+    server.SetMaxEditDistance(1);
+    ASSERT_EQUAL(server.GetMaxEditDistance(), 1u);
+    // опечатка находит близкие слова: cat удалением, cart заменой
+    ASSERT_EQUAL(found_ids("catt"), (std::vector<int>{ 1, 3, 4 }));
+    // при равной доле слова в документе точное совпадение выше нечёткого, хотя cot реже cat:
+    // вес cot - половина веса cat
+    const auto documents = server.FindTopDocuments(std::string{ "cat" });
+    ASSERT_EQUAL(documents.size(), 4u);
+    ASSERT_EQUAL(documents[0].id, 1);
+    ASSERT_EQUAL(documents[0].relevance, std::log(5.0 / 2.0));
+    ASSERT_EQUAL(documents[1].id, 2);
+    ASSERT_EQUAL(documents[1].relevance, 0.5 * std::log(5.0 / 2.0));
+    ASSERT_EQUAL(documents[2].id, 4);
+    ASSERT_EQUAL(documents[3].id, 3);
+    // до 2 символов правки не допускаются, до 5 - одна
+    ASSERT_EQUAL(found_ids("ca"), std::vector<int>{});
+    server.SetMaxEditDistance(2);
+    ASSERT_EQUAL(found_ids("parot"), std::vector<int>{ 5 });
+    ASSERT_EQUAL(found_ids("prot"), std::vector<int>{});
+    ASSERT_EQUAL(found_ids("paarrott"), std::vector<int>{ 5 });
+    // минус-слова и фразы не раскрываются
+    ASSERT_EQUAL(found_ids("dog -cot"), std::vector<int>{ 3 });
+    ASSERT(std::get<0>(server.MatchDocument(std::string{ "caat" }, 2)) == std::vector<std::string_view>{});
+    ASSERT(std::get<0>(server.MatchDocument(std::string{ "caat" }, 4)) == std::vector<std::string_view>{ "cat" });
+
+    // пакет и кэш дают те же результаты
+    server.SetResultCacheCapacity(1 << 16);
+    DocumentBatch batch;
+    server.FindTopDocumentsBatch({ "cat", "catt" }, batch);
+    ASSERT_EQUAL(batch.size(), 2u);
+    ASSERT_EQUAL(batch[0].size(), documents.size());
+    ASSERT_EQUAL(batch[0].begin()[2].relevance, documents[2].relevance);
+    ASSERT_EQUAL(batch[1].size(), 3u);
+    ASSERT_EQUAL(found_ids("cat"), (std::vector<int>{ 1, 2, 4, 3 }));
+    server.SetMaxEditDistance(0);
+    ASSERT_EQUAL(found_ids("cat"), (std::vector<int>{ 1, 4 }));
+
+    bool is_thrown = false;
+    try {
+        server.SetMaxEditDistance(3);
+    }
+    catch (const std::invalid_argument&) {
+        is_thrown = true;
+    }
+    ASSERT(is_thrown);
+}
+
+void Test_ShardedSearchServer_EqualsSingleServer() {
+    SearchServer single(std::string{ "and in" });
+    ShardedSearchServer sharded(std::string{ "and in" }, 4);
+    ASSERT_EQUAL(sharded.GetShardCount(), 4u);
+    const std::vector<std::string> words = { "cat", "dog", "bird", "fish", "city", "tail", "collar", "river", "house", "tree", "in", "and" };
+    std::vector<std::string> texts;
+    uint32_t seed = 7;
+    for (int id = 0; id < 300; ++id) {
+        seed = seed * 1103515245u + 12345u;
+        std::string text;
+        for (uint32_t i = 0, size = 2 + (seed >> 16) % 8; i < size; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            text += words[(seed >> 16) % words.size()] + ' ';
+        }
+        texts.push_back(text);
+    }
+    // половина документов добавляется по одному, половина - пакетом
+    std::vector<NewDocument> batch;
+    for (int id = 0; id < 300; ++id) {
+        const DocumentStatus status = id % 11 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        const std::vector<int> ratings = { id % 13 - 6 };
+        if (id < 150) {
+            single.AddDocument(id, texts[id], status, ratings);
+            sharded.AddDocument(id, texts[id], status, ratings);
+        }
+        else {
+            batch.push_back({ id, texts[id], status, ratings });
+        }
+    }
+    single.AddDocuments(batch);
+    sharded.AddDocuments(batch);
+    single.SetMaxResultDocumentCount(20);
+    sharded.SetMaxResultDocumentCount(20);
+
+    const auto assert_equal_results = [](const std::vector<Document>& expected, const std::vector<Document>& actual) {
+        ASSERT_EQUAL(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUAL(actual[i].id, expected[i].id);
+            ASSERT(std::abs(actual[i].relevance - expected[i].relevance) < 1e-9);
+            ASSERT_EQUAL(actual[i].rating, expected[i].rating);
+        }
+    };
+    const auto check = [&single, &sharded, &assert_equal_results]() {
+        ASSERT_EQUAL(sharded.GetDocumentCount(), single.GetDocumentCount());
+        const auto is_multiple_of_three = [](int document_id, DocumentStatus, int) {
+            return document_id % 3 == 0;
+        };
+        for (const std::string query : { "cat", "cat dog -fish", "bird river tree house", "city collar tail -cat", "and", "unknown" }) {
+            assert_equal_results(single.FindTopDocuments(query), sharded.FindTopDocuments(query));
+            assert_equal_results(single.FindTopDocuments(query, DocumentStatus::BANNED), sharded.FindTopDocuments(query, DocumentStatus::BANNED));
+            assert_equal_results(single.FindTopDocuments(query, is_multiple_of_three), sharded.FindTopDocuments(query, is_multiple_of_three));
+            assert_equal_results(single.FindTopDocuments(std::execution::seq, query, DocumentStatus::ACTUAL, 20, Bm25Scoring{}),
+                sharded.FindTopDocuments(query, DocumentStatus::ACTUAL, Bm25Scoring{}));
+        }
+    };
+    check();
+
+    for (int id = 0; id < 300; id += 5) {
+        single.RemoveDocument(id);
+        sharded.RemoveDocument(id);
+    }
+    std::vector<int> removed_ids;
+    for (int id = 1; id < 300; id += 7) {
+        removed_ids.push_back(id);
+    }
+    single.RemoveDocuments(removed_ids);
+    sharded.RemoveDocuments(removed_ids);
+    check();
+
+    single.SetIdfConsistency(IdfConsistency::EXACT);
+    sharded.SetIdfConsistency(IdfConsistency::EXACT);
+    check();
+
+    for (const int id : { 2, 3, 151, 299 }) {
+        ASSERT(sharded.MatchDocument("cat dog -fish", id) == single.MatchDocument("cat dog -fish", id));
+    }
+}
+
+void TestSearchServer() {
+    RUN_TEST(Test_ExcludeStopWords_FromAddedDocumentContent);
+    RUN_TEST(AddDocumentTest);
+    RUN_TEST(Test_GetWordFrequencies);
+    RUN_TEST(Test_RemoveDocument);
+    RUN_TEST(Test_RemoveDocument_ExcludedFromSearch);
+    RUN_TEST(TestExcludedMinusWords_WithOneDocument_ResultEmpty);
+    RUN_TEST_WITH_ARG(Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(std::string{ "cat" }));
+    RUN_TEST_WITH_ARG(Test_ExcludedMinusWords_WithOneDocument_ResultFindDocument(std::string{ "cat -dog" }));
+    RUN_TEST_WITH_ARG(TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(std::string{ "in -world" }, 42));
+    RUN_TEST_WITH_ARG(TestExcludedMinusWords_FromTwoDocument_ResultOneDocument(std::string{ "in -city" }, 104));
+    RUN_TEST(TestExcludedMinusWords_FromTwoDocuments_ResultTwoDocuments);
+    RUN_TEST(TestExcludedMinusWords_FromTwoDocuments_ResultEmpty);
+    RUN_TEST(Test_GetDocumentCount_ResultEmpty);
+    RUN_TEST(Test_GetDocumentCount_ResultThreeDocuments);
+    RUN_TEST(TestMatchDocument);
+    RUN_TEST(Test_FindTopDocuments_SortByRelevance);
+    RUN_TEST(Test_CalculateRating);
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::ACTUAL, 42));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::BANNED, 950));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::IRRELEVANT, 272));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithStatus_ResultFind(DocumentStatus::REMOVED, 104));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_EmptySearchServer_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }, std::string{ "cat dog" }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_EmptySearchServer_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }, std::string{ "" }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return rating > 5; }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return status != DocumentStatus::ACTUAL; }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat_ResultEmpty([](int id, DocumentStatus status, int rating) {return id != 42; }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return rating <= 5; }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return status == DocumentStatus::ACTUAL; }));
+    RUN_TEST_WITH_ARG(Test_FindTopDocuments_WithPredicat([](int id, DocumentStatus status, int rating) {return id == 42;  }));
+    RUN_TEST(Test_RelevanceCalculation);
+    RUN_TEST(Test_FindTopDocuments_ParallelEqualsSequenced);
+    RUN_TEST(Test_FindTopDocuments_ResultCount);
+    RUN_TEST(Test_FindTopDocuments_PrunedEqualsExhaustive);
+    RUN_TEST(Test_IdfConsistency_ExactEqualsIncremental);
+    RUN_TEST(Test_AddDocuments_EqualsAddDocument);
+    RUN_TEST(Test_AddDocuments_InvalidBatchLeavesIndexUnchanged);
+    RUN_TEST(Test_Snapshot_SaveAndLoad);
+    RUN_TEST(Test_PostingFormat_CompressedEqualsPlain);
+    RUN_TEST(Test_ConcurrentSearchServer_ReadWhileWriting);
+    RUN_TEST(Test_Segments_EqualSingleSegment);
+    RUN_TEST(Test_ParseQuery_DuplicatesAndInvalidWords);
+    RUN_TEST(Test_SplitIntoWords_Tokenizer);
+    RUN_TEST(Test_StopWordSet_Contains);
+    RUN_TEST(Test_QueryExecutor_EqualsFindTopDocuments);
+    RUN_TEST(Test_ResultCache_InvalidatedOnChange);
+    RUN_TEST(Test_StatusFilter_EqualsPredicate);
+    RUN_TEST(Test_RemoveDocument_TombstonesEqualRebuild);
+    RUN_TEST(Test_RemoveDuplicates_ExactAndNear);
+    RUN_TEST(Test_RequestStatistics_SlidingWindow);
+    RUN_TEST(Test_PhraseQueries_PositionIndex);
+    RUN_TEST(Test_ScoringPolicies_Bm25AndCustom);
+    RUN_TEST(Test_PrefixQueries_SortedDictionary);
+    RUN_TEST(Test_FuzzyQueries_LevenshteinAutomaton);
+    RUN_TEST(Test_ShardedSearchServer_EqualsSingleServer);
 }
\ No newline at end of file
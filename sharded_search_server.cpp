@@ -0,0 +1,116 @@
+#include "sharded_search_server.h"
+
+void ShardedSearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings) {
+    shards_[GetShardIndex(document_id)].AddDocument(document_id, document, status, ratings);
+}
+
+void ShardedSearchServer::AddDocuments(const std::vector<NewDocument>& documents) {
+    std::vector<std::vector<NewDocument>> shard_documents(shards_.size());
+    for (const NewDocument& document : documents) {
+        shard_documents[GetShardIndex(document.id)].push_back(document);
+    }
+    ForEachShard([this, &shard_documents](size_t shard_index) {
+        if (!shard_documents[shard_index].empty()) {
+            shards_[shard_index].AddDocuments(shard_documents[shard_index]);
+        }
+    });
+}
+
+void ShardedSearchServer::RemoveDocument(int document_id) {
+    shards_[GetShardIndex(document_id)].RemoveDocument(document_id);
+}
+
+void ShardedSearchServer::RemoveDocuments(const std::vector<int>& document_ids) {
+    std::vector<std::vector<int>> shard_document_ids(shards_.size());
+    for (const int document_id : document_ids) {
+        shard_document_ids[GetShardIndex(document_id)].push_back(document_id);
+    }
+    ForEachShard([this, &shard_document_ids](size_t shard_index) {
+        if (!shard_document_ids[shard_index].empty()) {
+            shards_[shard_index].RemoveDocuments(shard_document_ids[shard_index]);
+        }
+    });
+}
+
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentStatus status) const {
+    return FindTopDocuments(raw_query, status, TfIdfScoring{});
+}
+
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query) const {
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> ShardedSearchServer::MatchDocument(std::string_view raw_query, int document_id) const {
+    return shards_[GetShardIndex(document_id)].MatchDocument(raw_query, document_id);
+}
+
+void ShardedSearchServer::SetIdfConsistency(IdfConsistency consistency) {
+    ForEachShard([this, consistency](size_t shard_index) {
+        shards_[shard_index].SetIdfConsistency(consistency);
+    });
+}
+
+void ShardedSearchServer::SetPositionIndexing(bool enabled) {
+    for (SearchServer& shard : shards_) {
+        shard.SetPositionIndexing(enabled);
+    }
+}
+
+void ShardedSearchServer::SetProximityWeight(double weight) {
+    for (SearchServer& shard : shards_) {
+        shard.SetProximityWeight(weight);
+    }
+}
+
+void ShardedSearchServer::SetMaxPrefixExpansion(size_t max_term_count) {
+    for (SearchServer& shard : shards_) {
+        shard.SetMaxPrefixExpansion(max_term_count);
+    }
+}
+
+void ShardedSearchServer::SetMaxEditDistance(size_t max_distance) {
+    for (SearchServer& shard : shards_) {
+        shard.SetMaxEditDistance(max_distance);
+    }
+}
+
+void ShardedSearchServer::SetMaxResultDocumentCount(size_t result_count) noexcept {
+    max_result_document_count_ = result_count;
+}
+
+int ShardedSearchServer::GetDocumentCount() const noexcept {
+    int document_count = 0;
+    for (const SearchServer& shard : shards_) {
+        document_count += shard.GetDocumentCount();
+    }
+    return document_count;
+}
+
+size_t ShardedSearchServer::GetShardCount() const noexcept {
+    return shards_.size();
+}
+
+size_t ShardedSearchServer::GetShardIndex(int document_id) const noexcept {
+    // мультипликативный хеш: id с общим шагом, кратным числу шардов, не собираются в одном шарде
+    const uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(document_id)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>((hash >> 32) % shards_.size());
+}
+
+CollectionStatistics ShardedSearchServer::GetCollectionStatistics() const noexcept {
+    // средняя длина - той же формулой, что у одного сервера, чтобы BM25 совпадал до бита
+    size_t document_count = 0;
+    uint64_t total_length = 0;
+    for (const SearchServer& shard : shards_) {
+        document_count += static_cast<size_t>(shard.GetDocumentCount());
+        total_length += shard.GetTotalDocumentLength();
+    }
+    return { document_count, document_count == 0 ? 0.0 : static_cast<double>(total_length) / static_cast<double>(document_count) };
+}
+
+size_t ShardedSearchServer::GetDocumentFreq(std::string_view word) const {
+    size_t document_freq = 0;
+    for (const SearchServer& shard : shards_) {
+        document_freq += shard.GetDocumentFreq(word);
+    }
+    return document_freq;
+}
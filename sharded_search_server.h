@@ -0,0 +1,217 @@
+#pragma once
+
+#include "search_server.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <execution>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Поисковый сервер, разбитый на шарды: документ хранится в шарде по хешу id, у каждого шарда
+// свой SearchServer и свой поток пула. Запрос выполняют все шарды параллельно, и их лучшие документы
+// сливаются в общий top-K. Шарды ранжируют по статистике всех шардов (число документов, средняя длина,
+// df слов запроса), поэтому выдача совпадает с выдачей одного SearchServer с теми же документами.
+// Исключения: раскрытие префиксов и нечётких слов ограничивается по частотам в шарде, а близость слов
+// переранжирует лучших кандидатов шарда - там выдача может отличаться.
+// Как и SearchServer, сервер нельзя изменять параллельно с другими вызовами.
+class ShardedSearchServer {
+public:
+    template <typename StopWords>
+    explicit ShardedSearchServer(const StopWords& stop_words, size_t shard_count = std::thread::hardware_concurrency());
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+    // Документы добавляются во все шарды параллельно. При ошибке шард не изменяется,
+    // но другие шарды свои документы добавляют
+    void AddDocuments(const std::vector<NewDocument>& documents);
+    void RemoveDocument(int document_id);
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+    template <typename DocumentPredicate>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate) const;
+    [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status) const;
+    [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query) const;
+    // document_predicate вызывается из потоков шардов одновременно
+    template <typename ScoringPolicy, typename DocumentPredicate>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate, const ScoringPolicy& scoring) const;
+    template <typename ScoringPolicy>
+    [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status, const ScoringPolicy& scoring) const;
+
+    // слова документа есть только в его шарде, поэтому запрос идёт в один шард
+    [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::string_view raw_query, int document_id) const;
+
+    void SetIdfConsistency(IdfConsistency consistency);
+    void SetPositionIndexing(bool enabled);
+    void SetProximityWeight(double weight);
+    void SetMaxPrefixExpansion(size_t max_term_count);
+    void SetMaxEditDistance(size_t max_distance);
+    void SetMaxResultDocumentCount(size_t result_count) noexcept;
+
+    [[nodiscard]] int GetDocumentCount() const noexcept;
+    [[nodiscard]] size_t GetShardCount() const noexcept;
+
+private:
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    template <typename ScoringPolicy>
+    class GlobalScoring;
+
+    [[nodiscard]] size_t GetShardIndex(int document_id) const noexcept;
+    [[nodiscard]] CollectionStatistics GetCollectionStatistics() const noexcept;
+    [[nodiscard]] size_t GetDocumentFreq(std::string_view word) const;
+
+    // Вызывает function(shard_index) для всех шардов, каждый - в потоке своего шарда, а последний -
+    // в вызывающем потоке. Возвращается, когда закончены все вызовы; первое исключение пробрасывается
+    template <typename Function>
+    void ForEachShard(Function function) const;
+
+    // search(const SearchServer&) выполняется во всех шардах, из их документов отбираются лучшие
+    template <typename Search>
+    [[nodiscard]] std::vector<Document> GatherTopDocuments(Search search) const;
+
+    std::vector<SearchServer> shards_;
+    size_t max_result_document_count_ = MAX_RESULT_DOCUMENT_COUNT;
+    // объявлен после шардов: разрушается первым, дождавшись своих задач
+    mutable ThreadPool pool_;
+};
+
+// Политика ранжирования шарда: scoring, которому вместо статистики шарда передаётся статистика
+// всех шардов. df каждого слова запроса считается один раз на запрос и общий для шардов
+template <typename ScoringPolicy>
+class ShardedSearchServer::GlobalScoring {
+public:
+    GlobalScoring(const ScoringPolicy& scoring, const ShardedSearchServer& server)
+        : scoring_(scoring), server_(server), collection_(server.GetCollectionStatistics()),
+        consistency_(server.shards_.front().GetIdfConsistency())
+    {
+    }
+
+    [[nodiscard]] double TermWeight(const TermStatistics& term, const CollectionStatistics&) const {
+        const size_t document_freq = GetDocumentFreq(term.term);
+        const double inverse_document_freq = InverseDocumentFreqs::Compute(consistency_, static_cast<int>(collection_.document_count), document_freq);
+        return scoring_.TermWeight(TermStatistics{ document_freq, inverse_document_freq, term.term }, collection_);
+    }
+
+    template <typename Policy = ScoringPolicy, std::enable_if_t<!UsesDocumentLength<Policy>::value, int> = 0>
+    [[nodiscard]] double Score(double term_freq, double term_weight) const {
+        return scoring_.Score(term_freq, term_weight);
+    }
+
+    template <typename Policy = ScoringPolicy, std::enable_if_t<UsesDocumentLength<Policy>::value, int> = 0>
+    [[nodiscard]] double Score(double term_freq, double term_weight, const DocumentLength& document) const {
+        return scoring_.Score(term_freq, term_weight, DocumentLength{ document.length, collection_.average_document_length });
+    }
+
+    template <typename Policy = ScoringPolicy, std::enable_if_t<HasScoreUpperBound<Policy>::value, int> = 0>
+    [[nodiscard]] double UpperBound(double max_term_freq, double term_weight, const CollectionStatistics&) const {
+        return scoring_.UpperBound(max_term_freq, term_weight, collection_);
+    }
+
+private:
+    [[nodiscard]] size_t GetDocumentFreq(std::string_view word) const {
+        std::lock_guard lock(mutex_);
+        auto it = document_freqs_.find(word);
+        if (it == document_freqs_.end()) {
+            it = document_freqs_.emplace(std::string{ word }, server_.GetDocumentFreq(word)).first;
+        }
+        return it->second;
+    }
+
+    const ScoringPolicy& scoring_;
+    const ShardedSearchServer& server_;
+    CollectionStatistics collection_;
+    IdfConsistency consistency_;
+    mutable std::mutex mutex_;
+    mutable std::map<std::string, size_t, std::less<>> document_freqs_;
+};
+
+template <typename StopWords>
+ShardedSearchServer::ShardedSearchServer(const StopWords& stop_words, size_t shard_count)
+    : pool_(std::max<size_t>(shard_count, 1), QUEUE_CAPACITY)
+{
+    shards_.reserve(pool_.GetThreadCount());
+    for (size_t i = 0; i < pool_.GetThreadCount(); ++i) {
+        shards_.emplace_back(stop_words);
+    }
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate) const {
+    return FindTopDocuments(raw_query, document_predicate, TfIdfScoring{});
+}
+
+template <typename ScoringPolicy, typename DocumentPredicate>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate, const ScoringPolicy& scoring) const {
+    const GlobalScoring<ScoringPolicy> global_scoring(scoring, *this);
+    return GatherTopDocuments([this, raw_query, &document_predicate, &global_scoring](const SearchServer& shard) {
+        return shard.FindTopDocuments(std::execution::seq, raw_query, document_predicate, max_result_document_count_, global_scoring);
+    });
+}
+
+template <typename ScoringPolicy>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentStatus status, const ScoringPolicy& scoring) const {
+    const GlobalScoring<ScoringPolicy> global_scoring(scoring, *this);
+    return GatherTopDocuments([this, raw_query, status, &global_scoring](const SearchServer& shard) {
+        return shard.FindTopDocuments(std::execution::seq, raw_query, status, max_result_document_count_, global_scoring);
+    });
+}
+
+template <typename Function>
+void ShardedSearchServer::ForEachShard(Function function) const {
+    std::vector<std::future<void>> results;
+    results.reserve(shards_.size() - 1);
+    for (size_t i = 0; i + 1 < shards_.size(); ++i) {
+        ThreadPool::Task task([&function, i] {
+            function(i);
+        });
+        results.push_back(task.get_future());
+        pool_.SubmitTo(i, std::move(task));
+    }
+    // вызывающий поток не простаивает, а обрабатывает последний шард
+    std::exception_ptr error;
+    try {
+        function(shards_.size() - 1);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    // задачи ссылаются на function, поэтому выходить можно только после всех
+    for (std::future<void>& result : results) {
+        try {
+            result.get();
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename Search>
+std::vector<Document> ShardedSearchServer::GatherTopDocuments(Search search) const {
+    std::vector<std::vector<Document>> shard_documents(shards_.size());
+    ForEachShard([this, &search, &shard_documents](size_t shard_index) {
+        shard_documents[shard_index] = search(shards_[shard_index]);
+    });
+    // документ из общего top-K входит и в top-K своего шарда
+    std::vector<Document> documents;
+    for (const std::vector<Document>& shard_top : shard_documents) {
+        documents.insert(documents.end(), shard_top.begin(), shard_top.end());
+    }
+    SelectTopDocuments(std::execution::seq, documents, max_result_document_count_);
+    return documents;
+}
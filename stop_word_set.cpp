@@ -0,0 +1,84 @@
+#include "stop_word_set.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+StopWordSet::StopWordSet(const std::set<std::string, std::less<>>& words) {
+    offsets_.reserve(words.size() + 1);
+    offsets_.push_back(0);
+    for (const std::string& word : words) {
+        if (chars_.size() + word.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error(std::string{ "stop words are too long" });
+        }
+        chars_ += word;
+        offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    }
+    if (words.empty()) {
+        return;
+    }
+
+    // заполнение не больше половины: цепочки проб остаются короткими
+    size_t capacity = 16;
+    while (capacity < words.size() * 2) {
+        capacity *= 2;
+    }
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+
+    for (size_t index = 0; index < words.size(); ++index) {
+        const std::string_view word = GetWord(index);
+        if (word.empty()) {
+            throw std::invalid_argument(std::string{ "stop word is empty" });
+        }
+        const uint64_t hash = Hash(word);
+        size_t position = static_cast<size_t>(hash) & mask_;
+        while (slots_[position].length != 0) {
+            position = (position + 1) & mask_;
+        }
+        slots_[position] = { static_cast<uint32_t>(hash >> 32), offsets_[index], static_cast<uint32_t>(word.size()) };
+    }
+}
+
+bool StopWordSet::Contains(std::string_view word) const noexcept {
+    if (slots_.empty() || word.empty()) {
+        return false;
+    }
+    const uint64_t hash = Hash(word);
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t position = static_cast<size_t>(hash) & mask_;; position = (position + 1) & mask_) {
+        const Slot& slot = slots_[position];
+        if (slot.length == 0) {
+            return false;
+        }
+        if (slot.hash == tag && slot.length == word.size()
+            && std::memcmp(chars_.data() + slot.offset, word.data(), word.size()) == 0) {
+            return true;
+        }
+    }
+}
+
+std::string_view StopWordSet::GetWord(size_t index) const {
+    const uint32_t begin = offsets_.at(index);
+    return std::string_view(chars_).substr(begin, offsets_.at(index + 1) - begin);
+}
+
+size_t StopWordSet::size() const noexcept {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+}
+
+bool StopWordSet::empty() const noexcept {
+    return size() == 0;
+}
+
+uint64_t StopWordSet::Hash(std::string_view word) noexcept {
+    // FNV-1a с финальным перемешиванием: младшие биты идут в индекс, старшие — в метку
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : word) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
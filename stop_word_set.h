@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Неизменяемое множество стоп-слов: открытая адресация с линейным пробированием.
+// Проверка слова не выделяет память: один хеш, обычно одна ячейка и одно сравнение.
+class StopWordSet {
+public:
+    StopWordSet() = default;
+    explicit StopWordSet(const std::set<std::string, std::less<>>& words);
+
+    [[nodiscard]] bool Contains(std::string_view word) const noexcept;
+
+    // слова в порядке возрастания
+    [[nodiscard]] std::string_view GetWord(size_t index) const;
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    // length == 0 — пустая ячейка (стоп-слова непустые)
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    [[nodiscard]] static uint64_t Hash(std::string_view word) noexcept;
+
+    // слова лежат подряд, смещения вместо string_view — копия множества остаётся корректной
+    std::string chars_;
+    std::vector<uint32_t> offsets_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+};
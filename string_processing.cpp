@@ -1,19 +1,95 @@
-#include "string_processing.h"
-
-#include <iostream>
-
-std::vector < std::string_view > SplitIntoWords(std::string_view str) {
-    std::vector<std::string_view> result;
-    const int64_t pos_end = str.npos;
-    while (true) {
-        int64_t space = str.find(' ');
-        result.push_back(space == pos_end ? str.substr(0) : str.substr(0, space));
-        if (space == pos_end) {
-            break;
-        }
-        else {
-            str.remove_prefix(static_cast<int64_t>(space) + 1);
-        }
-    }
-    return result;
-}
+#include "string_processing.h"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STRING_PROCESSING_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    bool IsControlCharacter(char c) noexcept {
+        return static_cast<unsigned char>(c) <= 31;
+    }
+
+    [[maybe_unused]] unsigned CountTrailingZeros(uint32_t mask) noexcept {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+#ifdef STRING_PROCESSING_SSE2
+    // маски пробелов и управляющих символов в 16 байтах начиная с data
+    void FindDelimiters(const char* data, uint32_t& space_mask, uint32_t& control_mask) noexcept {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        space_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '))));
+        // беззнаковое сравнение c <= 31 через min(c, 31) == c
+        control_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(31)), chunk)));
+    }
+#endif
+}
+
+bool SplitIntoWords(std::string_view str, std::vector<std::string_view>& words) {
+    const char* const data = str.data();
+    size_t word_begin = 0;
+    size_t i = 0;
+#ifdef STRING_PROCESSING_SSE2
+    for (; i + 16 <= str.size(); i += 16) {
+        uint32_t space_mask;
+        uint32_t control_mask;
+        FindDelimiters(data + i, space_mask, control_mask);
+        if (control_mask != 0) {
+            return false;
+        }
+        for (; space_mask != 0; space_mask &= space_mask - 1) {
+            const size_t space = i + CountTrailingZeros(space_mask);
+            if (space > word_begin) {
+                words.emplace_back(data + word_begin, space - word_begin);
+            }
+            word_begin = space + 1;
+        }
+    }
+#endif
+    for (; i < str.size(); ++i) {
+        if (IsControlCharacter(data[i])) {
+            return false;
+        }
+        if (data[i] == ' ') {
+            if (i > word_begin) {
+                words.emplace_back(data + word_begin, i - word_begin);
+            }
+            word_begin = i + 1;
+        }
+    }
+    if (str.size() > word_begin) {
+        words.emplace_back(data + word_begin, str.size() - word_begin);
+    }
+    return true;
+}
+
+bool ContainsControlCharacters(std::string_view str) noexcept {
+    size_t i = 0;
+#ifdef STRING_PROCESSING_SSE2
+    for (; i + 16 <= str.size(); i += 16) {
+        uint32_t space_mask;
+        uint32_t control_mask;
+        FindDelimiters(str.data() + i, space_mask, control_mask);
+        if (control_mask != 0) {
+            return true;
+        }
+    }
+#endif
+    for (; i < str.size(); ++i) {
+        if (IsControlCharacter(str[i])) {
+            return true;
+        }
+    }
+    return false;
+}
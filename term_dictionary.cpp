@@ -0,0 +1,96 @@
+#include "term_dictionary.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+TermDictionary::TermId TermDictionary::Intern(std::string_view term) {
+    if (auto iter = ids_.find(term); iter != ids_.end()) {
+        return iter->second;
+    }
+    if (terms_.size() >= NO_TERM) {
+        throw std::length_error(std::string{ "term dictionary is full" });
+    }
+    const std::string_view stored = StoreInArena(term);
+    const TermId id = static_cast<TermId>(terms_.size());
+    terms_.push_back(stored);
+    ids_.emplace(stored, id);
+    AddSorted(id);
+    return id;
+}
+
+TermDictionary::TermId TermDictionary::InternExternal(std::string_view term) {
+    if (auto iter = ids_.find(term); iter != ids_.end()) {
+        return iter->second;
+    }
+    if (terms_.size() >= NO_TERM) {
+        throw std::length_error(std::string{ "term dictionary is full" });
+    }
+    const TermId id = static_cast<TermId>(terms_.size());
+    terms_.push_back(term);
+    ids_.emplace(term, id);
+    AddSorted(id);
+    return id;
+}
+
+TermDictionary::TermId TermDictionary::Find(std::string_view term) const {
+    if (auto iter = ids_.find(term); iter != ids_.end()) {
+        return iter->second;
+    }
+    return NO_TERM;
+}
+
+std::string_view TermDictionary::GetTerm(TermId id) const {
+    return terms_.at(id);
+}
+
+size_t TermDictionary::size() const noexcept {
+    return terms_.size();
+}
+
+std::string_view TermDictionary::StoreInArena(std::string_view term) {
+    // длинные слова получают собственный кусок, чтобы не тратить место в общем
+    if (term.size() > ARENA_CHUNK_SIZE / 4) {
+        arena_chunks_.push_back(std::make_unique<char[]>(term.size()));
+        std::memcpy(arena_chunks_.back().get(), term.data(), term.size());
+        return { arena_chunks_.back().get(), term.size() };
+    }
+    if (chunk_used_ + term.size() > ARENA_CHUNK_SIZE) {
+        arena_chunks_.push_back(std::make_unique<char[]>(ARENA_CHUNK_SIZE));
+        chunk_ = arena_chunks_.back().get();
+        chunk_used_ = 0;
+    }
+    char* place = chunk_ + chunk_used_;
+    std::memcpy(place, term.data(), term.size());
+    chunk_used_ += term.size();
+    return { place, term.size() };
+}
+
+void TermDictionary::AddSorted(TermId id) {
+    unsorted_tail_.push_back(id);
+    if (unsorted_tail_.size() < UNSORTED_TAIL_SIZE) {
+        return;
+    }
+    std::vector<std::pair<std::string_view, TermId>> tail;
+    tail.reserve(unsorted_tail_.size());
+    for (const TermId tail_id : unsorted_tail_) {
+        tail.emplace_back(terms_[tail_id], tail_id);
+    }
+    std::sort(tail.begin(), tail.end());
+    unsorted_tail_.clear();
+
+    FrontCodedTerms run;
+    run.Build(tail);
+    for (size_t level = 0; ; ++level) {
+        if (level == sorted_levels_.size()) {
+            sorted_levels_.emplace_back();
+        }
+        sorted_levels_[level].push_back(std::move(run));
+        if (sorted_levels_[level].size() < SORTED_RUN_FANOUT) {
+            break;
+        }
+        run = FrontCodedTerms::Merge(sorted_levels_[level]);
+        sorted_levels_[level].clear();
+    }
+}
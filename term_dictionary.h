@@ -0,0 +1,93 @@
+#pragma once
+
+#include "front_coded_terms.h"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Словарь термов: каждому слову сопоставляется плотный id.
+// Строки хранятся в собственной арене, поэтому string_view на них
+// остаются валидными всё время жизни словаря (в том числе после перемещения).
+// Для поиска по префиксу термы ещё и упорядочены - как в LSM-дереве: новые id копятся
+// в коротком неупорядоченном хвосте, полный хвост сортируется в сжатый прогон FrontCodedTerms
+// нулевого уровня, а SORTED_RUN_FANOUT прогонов одного уровня сливаются в прогон следующего.
+// Терм перекодируется O(log n) раз, прогонов O(log n), и каждый читается последовательно.
+class TermDictionary {
+public:
+    using TermId = uint32_t;
+    static constexpr TermId NO_TERM = UINT32_MAX;
+
+    TermDictionary() = default;
+    TermDictionary(const TermDictionary&) = delete;
+    TermDictionary& operator=(const TermDictionary&) = delete;
+    TermDictionary(TermDictionary&&) = default;
+    TermDictionary& operator=(TermDictionary&&) = default;
+
+    TermId Intern(std::string_view term);
+
+    // регистрирует терм без копирования: память term должна жить дольше словаря
+    TermId InternExternal(std::string_view term);
+
+    [[nodiscard]] TermId Find(std::string_view term) const;
+
+    [[nodiscard]] std::string_view GetTerm(TermId id) const;
+
+    [[nodiscard]] size_t size() const noexcept;
+
+    // function(std::string_view term, TermId id) для каждого терма с префиксом prefix, в произвольном порядке
+    template <typename Function>
+    void ForEachWithPrefix(std::string_view prefix, Function function) const;
+
+    // function(std::string_view term, TermId id) для каждого терма, принятого автоматом
+    // (см. FrontCodedTerms::ForEachAccepted), в произвольном порядке
+    template <typename Automaton, typename Function>
+    void ForEachAccepted(Automaton& automaton, Function function) const;
+
+private:
+    static constexpr size_t ARENA_CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t UNSORTED_TAIL_SIZE = 256;
+    static constexpr size_t SORTED_RUN_FANOUT = 4;
+
+    [[nodiscard]] std::string_view StoreInArena(std::string_view term);
+    void AddSorted(TermId id);
+
+    std::vector<std::unique_ptr<char[]>> arena_chunks_;
+    char* chunk_ = nullptr;
+    size_t chunk_used_ = ARENA_CHUNK_SIZE;
+    std::unordered_map<std::string_view, TermId> ids_;
+    std::vector<std::string_view> terms_;
+    // sorted_levels_[i] - прогоны по UNSORTED_TAIL_SIZE * SORTED_RUN_FANOUT^i термов
+    std::vector<std::vector<FrontCodedTerms>> sorted_levels_;
+    std::vector<TermId> unsorted_tail_;
+};
+
+template <typename Function>
+void TermDictionary::ForEachWithPrefix(std::string_view prefix, Function function) const {
+    for (const std::vector<FrontCodedTerms>& level : sorted_levels_) {
+        for (const FrontCodedTerms& run : level) {
+            run.ForEachWithPrefix(prefix, function);
+        }
+    }
+    for (const TermId id : unsorted_tail_) {
+        if (terms_[id].substr(0, prefix.size()) == prefix) {
+            function(terms_[id], id);
+        }
+    }
+}
+
+template <typename Automaton, typename Function>
+void TermDictionary::ForEachAccepted(Automaton& automaton, Function function) const {
+    for (const std::vector<FrontCodedTerms>& level : sorted_levels_) {
+        for (const FrontCodedTerms& run : level) {
+            run.ForEachAccepted(automaton, function);
+        }
+    }
+    for (const TermId id : unsorted_tail_) {
+        if (automaton.Feed(terms_[id]) == 0 && automaton.IsAccepted()) {
+            function(terms_[id], id);
+        }
+    }
+}
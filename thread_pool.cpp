@@ -0,0 +1,106 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // пул и номер потока, если текущий поток принадлежит пулу
+    thread_local const ThreadPool* current_pool = nullptr;
+    thread_local size_t current_worker = 0;
+}
+
+ThreadPool::ThreadPool(size_t thread_count, size_t queue_capacity)
+    : queue_capacity_(std::max<size_t>(queue_capacity, 1))
+{
+    thread_count = std::max<size_t>(thread_count, 1);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back([this, i] { Run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+    space_available_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(Task task) {
+    Enqueue(std::move(task), std::nullopt);
+}
+
+void ThreadPool::SubmitTo(size_t worker_index, Task task) {
+    Enqueue(std::move(task), worker_index % workers_.size());
+}
+
+void ThreadPool::Enqueue(Task task, std::optional<size_t> worker_index) {
+    const bool is_pool_thread = current_pool == this;
+    std::unique_lock lock(mutex_);
+    if (!is_pool_thread) {
+        space_available_.wait(lock, [this] { return queued_count_ < queue_capacity_ || stopping_; });
+    }
+    if (stopping_ && !is_pool_thread) {
+        throw std::logic_error(std::string{ "thread pool is stopping" });
+    }
+    if (!worker_index) {
+        // задача потока пула остаётся у него: её данные, скорее всего, ещё в его кэше
+        worker_index = is_pool_thread ? current_worker : next_worker_++ % workers_.size();
+    }
+    {
+        std::lock_guard worker_lock(workers_[*worker_index]->mutex);
+        workers_[*worker_index]->tasks.push_back(std::move(task));
+    }
+    ++queued_count_;
+    lock.unlock();
+    task_available_.notify_one();
+}
+
+size_t ThreadPool::GetThreadCount() const noexcept {
+    return threads_.size();
+}
+
+void ThreadPool::Run(size_t worker_index) {
+    current_pool = this;
+    current_worker = worker_index;
+    Task task;
+    while (true) {
+        if (TryTake(worker_index, task)) {
+            {
+                std::lock_guard lock(mutex_);
+                --queued_count_;
+            }
+            space_available_.notify_one();
+            task();
+            continue;
+        }
+        std::unique_lock lock(mutex_);
+        task_available_.wait(lock, [this] { return queued_count_ > 0 || stopping_; });
+        if (stopping_ && queued_count_ == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::TryTake(size_t worker_index, Task& task) {
+    // и свои, и чужие задачи берутся с начала очереди: сначала самые старые, ради задержки
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        Worker& worker = *workers_[(worker_index + i) % workers_.size()];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Пул потоков с собственной очередью у каждого потока: задачи раскладываются по очередям
+// по кругу, а освободившийся поток забирает задачи из чужих очередей.
+// Очередь ограничена: Submit снаружи пула ждёт, пока в очередях не станет меньше queue_capacity задач,
+// поэтому под постоянным потоком запросов задержка не растёт из-за бесконечной очереди.
+// Задачи, поставленные из потока пула, не ждут (иначе пул может заблокировать сам себя).
+class ThreadPool {
+public:
+    using Task = std::packaged_task<void()>;
+
+    ThreadPool(size_t thread_count, size_t queue_capacity);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // выполняет все поставленные задачи и останавливает потоки
+    ~ThreadPool();
+
+    void Submit(Task task);
+    // Ставит задачу в очередь потока worker_index % GetThreadCount(): поток берёт свои задачи первыми,
+    // поэтому задачи с общими данными выполняются одним потоком, пока остальные не простаивают
+    void SubmitTo(size_t worker_index, Task task);
+
+    [[nodiscard]] size_t GetThreadCount() const noexcept;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // worker_index пуст - очередь выбирается по кругу
+    void Enqueue(Task task, std::optional<size_t> worker_index);
+    void Run(size_t worker_index);
+    [[nodiscard]] bool TryTake(size_t worker_index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    const size_t queue_capacity_;
+    std::atomic<size_t> next_worker_ = 0;
+
+    // число задач в очередях и флаг остановки
+    std::mutex mutex_;
+    std::condition_variable task_available_;
+    std::condition_variable space_available_;
+    size_t queued_count_ = 0;
+    bool stopping_ = false;
+};
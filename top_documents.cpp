@@ -0,0 +1,58 @@
+#include "top_documents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+bool IsMoreRelevant(const Document& lhs, const Document& rhs) noexcept {
+    if (std::abs(lhs.relevance - rhs.relevance) < 1e-6) {
+        if (lhs.rating == rhs.rating) {
+            return lhs.id < rhs.id;
+        }
+        return lhs.rating > rhs.rating;
+    }
+    return lhs.relevance > rhs.relevance;
+}
+
+TopDocuments::TopDocuments(size_t capacity)
+    : capacity_(capacity)
+{
+    heap_.reserve(std::min(capacity_, MAX_RESERVED_CAPACITY));
+}
+
+void TopDocuments::Push(const Document& document) {
+    if (capacity_ == 0) {
+        return;
+    }
+    // IsMoreRelevant как "меньше" делает вершиной кучи наименее релевантный документ
+    if (heap_.size() < capacity_) {
+        heap_.push_back(document);
+        std::push_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+    }
+    else if (IsMoreRelevant(document, heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+        heap_.back() = document;
+        std::push_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+    }
+}
+
+bool TopDocuments::IsFull() const noexcept {
+    return heap_.size() == capacity_;
+}
+
+const Document& TopDocuments::GetWorst() const {
+    if (heap_.empty()) {
+        throw std::out_of_range(std::string{ "top documents are empty" });
+    }
+    return heap_.front();
+}
+
+size_t TopDocuments::size() const noexcept {
+    return heap_.size();
+}
+
+std::vector<Document> TopDocuments::Extract() {
+    std::sort_heap(heap_.begin(), heap_.end(), IsMoreRelevant);
+    return std::move(heap_);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "document.h"
+
+#include <algorithm>
+#include <execution>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Порядок выдачи: релевантность по убыванию, при равенстве (с точностью 1e-6) - рейтинг
+// по убыванию, затем id по возрастанию, чтобы seq и par давали одинаковый результат
+[[nodiscard]] bool IsMoreRelevant(const Document& lhs, const Document& rhs) noexcept;
+
+// Ограниченная куча лучших документов: в вершине - худший из отобранных
+class TopDocuments {
+public:
+    explicit TopDocuments(size_t capacity);
+
+    void Push(const Document& document);
+
+    [[nodiscard]] bool IsFull() const noexcept;
+    [[nodiscard]] const Document& GetWorst() const;
+    [[nodiscard]] size_t size() const noexcept;
+
+    // отобранные документы в порядке выдачи
+    [[nodiscard]] std::vector<Document> Extract();
+
+private:
+    // capacity приходит от вызывающего и может быть сколь угодно большим: заранее резервируется
+    // не больше этого, дальше куча растёт по мере добавления
+    static constexpr size_t MAX_RESERVED_CAPACITY = 1024;
+
+    size_t capacity_;
+    std::vector<Document> heap_;
+};
+
+// Оставляет в documents лучшие result_count документов в порядке выдачи
+template <typename ExecutionPolicy>
+void SelectTopDocuments(ExecutionPolicy policy, std::vector<Document>& documents, size_t result_count);
+
+namespace top_documents_detail {
+    inline void SelectTopDocumentsSeq(std::vector<Document>& documents, size_t result_count) {
+        if (documents.size() > result_count) {
+            std::nth_element(documents.begin(), documents.begin() + result_count, documents.end(), IsMoreRelevant);
+            documents.resize(result_count);
+        }
+        std::sort(documents.begin(), documents.end(), IsMoreRelevant);
+    }
+
+    // не дробим выборку, если в куске меньше документов: дешевле сделать её в одном потоке
+    constexpr size_t MIN_DOCUMENTS_PER_CHUNK = 1 << 14;
+}
+
+template <typename ExecutionPolicy>
+void SelectTopDocuments(ExecutionPolicy policy, std::vector<Document>& documents, size_t result_count) {
+    using namespace top_documents_detail;
+    const size_t chunk_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+        documents.size() / std::max(MIN_DOCUMENTS_PER_CHUNK, result_count * 4));
+    if (std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy> || chunk_count < 2) {
+        SelectTopDocumentsSeq(documents, result_count);
+        return;
+    }
+
+    // каждый кусок отбирает свои result_count лучших, затем кандидаты сливаются
+    const size_t chunk_size = (documents.size() + chunk_count - 1) / chunk_count;
+    std::vector<std::vector<Document>> chunk_tops(chunk_count);
+    std::vector<size_t> chunk_indexes(chunk_count);
+    for (size_t i = 0; i < chunk_count; ++i) {
+        chunk_indexes[i] = i;
+    }
+    std::for_each(policy, chunk_indexes.begin(), chunk_indexes.end(), [&](size_t chunk_index) {
+        const auto first = documents.begin() + std::min(documents.size(), chunk_index * chunk_size);
+        const auto last = documents.begin() + std::min(documents.size(), (chunk_index + 1) * chunk_size);
+        std::vector<Document> chunk(first, last);
+        SelectTopDocumentsSeq(chunk, result_count);
+        chunk_tops[chunk_index] = std::move(chunk);
+    });
+
+    documents.clear();
+    for (const auto& chunk : chunk_tops) {
+        documents.insert(documents.end(), chunk.begin(), chunk.end());
+    }
+    SelectTopDocumentsSeq(documents, result_count);
+}